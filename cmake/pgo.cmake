@@ -0,0 +1,107 @@
+# pgo.cmake: profile-guided, link-time optimized build trained on the sweep workload
+#
+#   cmake --build build --target pgo
+# or, without a configured tree:
+#   cmake -D SOURCE_DIR=. -D PGO_BINARY_DIR=build/pgo -P cmake/pgo.cmake
+#
+# 1. baseline:  Release build, the reference for the speedup
+# 2. training:  the same tree with MATHFUNCTION_PGO=GENERATE; runs the accuracy
+#               sweep, the Pareto report and the regression tests, which
+#               exercise every kernel and type and the C ABI library
+# 3. optimized: the training tree reconfigured with MATHFUNCTION_PGO=USE and
+#               MATHFUNCTION_LTO=ON and rebuilt; the profiles name its object
+#               files, so the tree must stay in place between the two phases
+# 4. report:    the Pareto report of the optimized build against the baseline,
+#               in PGO_BINARY_DIR/report/sqrt_pareto_speedup.csv
+#
+# The production binaries are those of PGO_BINARY_DIR/optimized.
+cmake_minimum_required(VERSION 3.22)
+
+if (NOT DEFINED SOURCE_DIR OR NOT DEFINED PGO_BINARY_DIR)
+	message(FATAL_ERROR "pgo.cmake needs -D SOURCE_DIR=<source tree> -D PGO_BINARY_DIR=<build directory>")
+endif()
+get_filename_component(SOURCE_DIR ${SOURCE_DIR} ABSOLUTE)
+get_filename_component(PGO_BINARY_DIR ${PGO_BINARY_DIR} ABSOLUTE)
+if (NOT DEFINED PGO_TRAINING_SAMPLES)
+	# inputs per wide type in the accuracy sweep; the 16-bit types are swept over every encoding
+	set(PGO_TRAINING_SAMPLES 16384)
+endif()
+
+set(baseline_dir ${PGO_BINARY_DIR}/baseline)
+set(optimized_dir ${PGO_BINARY_DIR}/optimized)
+set(profile_dir ${PGO_BINARY_DIR}/profile)
+set(training_dir ${PGO_BINARY_DIR}/training)
+set(report_dir ${PGO_BINARY_DIR}/report)
+
+# the configure options of the calling tree carry over to every build
+set(configure_options -D CMAKE_BUILD_TYPE=Release)
+foreach (variable CMAKE_GENERATOR CMAKE_C_COMPILER CMAKE_CXX_COMPILER STARTER_UNIVERSAL_INCLUDE_DIR)
+	if (DEFINED ${variable} AND NOT "${${variable}}" STREQUAL "")
+		if (variable STREQUAL "CMAKE_GENERATOR")
+			list(APPEND configure_options -G ${${variable}})
+		else()
+			list(APPEND configure_options -D ${variable}=${${variable}})
+		endif()
+	endif()
+endforeach()
+
+include(ProcessorCount)
+ProcessorCount(jobs)
+if (jobs EQUAL 0)
+	set(jobs 1)
+endif()
+
+function(run step)
+	message(STATUS "pgo: ${step}")
+	execute_process(COMMAND ${ARGN} RESULT_VARIABLE result)
+	if (NOT result EQUAL 0)
+		message(FATAL_ERROR "pgo: ${step} failed (${result})")
+	endif()
+endfunction()
+
+function(run_in directory step)
+	file(MAKE_DIRECTORY ${directory})
+	message(STATUS "pgo: ${step}")
+	execute_process(COMMAND ${ARGN} WORKING_DIRECTORY ${directory} RESULT_VARIABLE result)
+	if (NOT result EQUAL 0)
+		message(FATAL_ERROR "pgo: ${step} failed (${result})")
+	endif()
+endfunction()
+
+# 1. baseline
+run("configure the baseline build" ${CMAKE_COMMAND} -S ${SOURCE_DIR} -B ${baseline_dir} ${configure_options}
+	-D MATHFUNCTION_PGO=OFF -D MATHFUNCTION_LTO=OFF)
+run("build the baseline" ${CMAKE_COMMAND} --build ${baseline_dir} --target pareto -j ${jobs})
+
+# 2. instrumented build and training run; stale profiles would mix with the new ones
+file(REMOVE_RECURSE ${profile_dir} ${training_dir})
+run("configure the instrumented build" ${CMAKE_COMMAND} -S ${SOURCE_DIR} -B ${optimized_dir} ${configure_options}
+	-D MATHFUNCTION_PGO=GENERATE -D MATHFUNCTION_PGO_DIR=${profile_dir} -D MATHFUNCTION_LTO=OFF)
+run("build the instrumented binaries" ${CMAKE_COMMAND} --build ${optimized_dir} -j ${jobs})
+file(GLOB accuracy ${optimized_dir}/src/apps/accuracy/accuracy ${optimized_dir}/src/apps/accuracy/accuracy.exe)
+file(GLOB pareto ${optimized_dir}/src/apps/pareto/pareto ${optimized_dir}/src/apps/pareto/pareto.exe)
+run_in(${training_dir} "training: accuracy sweep" ${accuracy} --no-cache --samples ${PGO_TRAINING_SAMPLES})
+run_in(${training_dir} "training: Pareto report" ${pareto})
+# failing tests, such as a perf gate on instrumented code, still leave their profiles
+execute_process(COMMAND ${CMAKE_CTEST_COMMAND} --test-dir ${optimized_dir} --output-on-failure WORKING_DIRECTORY ${training_dir})
+
+# gcc reads its .gcda files as they are; clang needs its raw profiles merged into one
+file(GLOB profraw ${profile_dir}/*.profraw)
+if (profraw)
+	find_program(LLVM_PROFDATA NAMES llvm-profdata llvm-profdata-19 llvm-profdata-18 llvm-profdata-17 llvm-profdata-16 llvm-profdata-15 llvm-profdata-14)
+	if (NOT LLVM_PROFDATA)
+		message(FATAL_ERROR "pgo: clang profiles need llvm-profdata to merge them; pass -D LLVM_PROFDATA=<path>")
+	endif()
+	run("merge the clang profiles" ${LLVM_PROFDATA} merge -output=${profile_dir}/default.profdata ${profraw})
+endif()
+
+# 3. profile-guided, link-time optimized rebuild of the same tree
+run("configure the optimized build" ${CMAKE_COMMAND} -S ${SOURCE_DIR} -B ${optimized_dir} ${configure_options}
+	-D MATHFUNCTION_PGO=USE -D MATHFUNCTION_PGO_DIR=${profile_dir} -D MATHFUNCTION_LTO=ON)
+run("build the optimized binaries" ${CMAKE_COMMAND} --build ${optimized_dir} -j ${jobs})
+
+# 4. speedup report
+file(GLOB baseline_pareto ${baseline_dir}/src/apps/pareto/pareto ${baseline_dir}/src/apps/pareto/pareto.exe)
+run_in(${report_dir}/baseline "benchmark the baseline" ${baseline_pareto})
+run_in(${report_dir} "benchmark the optimized build" ${pareto} --baseline ${report_dir}/baseline/sqrt_pareto.csv)
+message(STATUS "pgo: optimized binaries in ${optimized_dir}, speedup per pair in ${report_dir}/sqrt_pareto_speedup.csv")
@@ -0,0 +1,265 @@
+#pragma once
+// adaptive_sampler.hpp: error maps that spend their samples where the error spikes
+//
+// The positive encodings of a type are cut into a coarse grid of bands,
+// each sampled at a few encodings drawn from Philox. Every round then
+// splits the bands whose largest error or error spread is above a
+// threshold, worst first, into fanout sub-bands. A sub-band keeps the
+// samples of its parent that fall in it and draws only the rest, never
+// an encoding it already holds. Rounds stop when the budget of kernel
+// calls is spent or no band is above the thresholds. A band no wider
+// than its sample count is evaluated at every encoding and not split
+// further. The positive values of every type are ordered like their
+// encodings, so the grid follows the dynamic range: binades for IEEE
+// types and posits, equal steps for fixpnt. The encodings drawn depend
+// only on the seed and the band, so a run is reproducible.
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include <mathfunction/encoding.hpp>
+#include <mathfunction/error_stats.hpp>
+#include <mathfunction/philox.hpp>
+#include <mathfunction/ulp.hpp>
+
+struct adaptive_options {
+    uint64_t budget = uint64_t(1) << 16;   // kernel calls in all
+    unsigned grid = 64;                    // bands of the first round
+    unsigned samples = 32;                 // per band
+    unsigned fanout = 4;                   // sub-bands per split
+    double max_ulp = 1.0;                  // split bands whose largest error is above this
+    double max_stddev = 0.5;               // or whose errors spread more than this
+    uint64_t seed = 0x5eed;
+};
+
+struct error_sample {
+    uint64_t encoding;
+    double ulp;           // infinite where the kernel threw
+};
+
+struct error_band {
+    uint64_t first = 0;   // encodings [first, last]
+    uint64_t last = 0;
+    unsigned depth = 0;   // splits from the first grid
+    bool exhaustive = false;
+    std::vector<error_sample> samples;
+
+    uint64_t width() const { return last - first + 1; }
+
+    const error_sample* worst() const {
+        auto it = std::max_element(samples.begin(), samples.end(), [](const error_sample& a, const error_sample& b) { return a.ulp < b.ulp; });
+        return (it == samples.end()) ? nullptr : &*it;
+    }
+    double max_ulp() const {
+        const error_sample* w = worst();
+        return w ? w->ulp : 0.0;
+    }
+    // moments of the finite errors
+    double mean() const {
+        double sum = 0.0;
+        size_t n = 0;
+        for (const auto& s : samples) {
+            if (std::isfinite(s.ulp)) { sum += s.ulp; ++n; }
+        }
+        return n ? sum / static_cast<double>(n) : 0.0;
+    }
+    double stddev() const {
+        double m = mean(), sum = 0.0;
+        size_t n = 0;
+        for (const auto& s : samples) {
+            if (std::isfinite(s.ulp)) { sum += (s.ulp - m) * (s.ulp - m); ++n; }
+        }
+        return n > 1 ? std::sqrt(sum / static_cast<double>(n - 1)) : 0.0;
+    }
+    uint64_t failures() const {
+        return static_cast<uint64_t>(std::count_if(samples.begin(), samples.end(), [](const error_sample& s) { return std::isinf(s.ulp); }));
+    }
+};
+
+struct adaptive_result {
+    std::vector<error_band> bands;   // in encoding order, covering every positive encoding
+    uint64_t calls = 0;
+    uint64_t encodings = 0;          // positive encodings, the calls of a dense sweep
+    unsigned rounds = 0;
+
+    // Statistics of every sample, with the value of the input as the argument.
+    // The samples crowd into the refined bands, so only the largest error and
+    // the failures speak for the whole range, not the moments or quantiles
+    template <typename T>
+    error_stats stats() const {
+        error_stats all;
+        for (const auto& band : bands) {
+            for (const auto& s : band.samples) {
+                if (std::isinf(s.ulp)) ++all.failures;
+                else all.add(s.ulp, static_cast<double>(decode<T>(static_cast<encoding_word_t<T>>(s.encoding))));
+            }
+        }
+        return all;
+    }
+};
+
+namespace adaptive_detail {
+
+// First encoding of part k of fanout equal parts of [first, last]
+inline uint64_t part_first(uint64_t first, uint64_t width, unsigned fanout, unsigned k) {
+    return first + (width / fanout) * k + std::min<uint64_t>(k, width % fanout);
+}
+
+inline std::vector<error_band> split(const error_band& band, unsigned parts) {
+    std::vector<error_band> children;
+    const uint64_t width = band.width();
+    parts = static_cast<unsigned>(std::min<uint64_t>(parts, width));
+    for (unsigned k = 0; k < parts; ++k) {
+        error_band child;
+        child.first = part_first(band.first, width, parts, k);
+        child.last = part_first(band.first, width, parts, k + 1) - 1;
+        child.depth = band.depth + 1;
+        for (const auto& s : band.samples) {
+            if (s.encoding >= child.first && s.encoding <= child.last) child.samples.push_back(s);
+        }
+        children.push_back(std::move(child));
+    }
+    return children;
+}
+
+// Encodings still to evaluate for band to hold its samples
+inline std::vector<uint64_t> fresh_encodings(error_band& band, unsigned samples, const philox4x32& rng) {
+    std::vector<uint64_t> fresh;
+    if (band.width() <= samples) {
+        band.exhaustive = true;
+        std::vector<uint64_t> seen;
+        for (const auto& s : band.samples) seen.push_back(s.encoding);
+        std::sort(seen.begin(), seen.end());
+        for (uint64_t e = band.first;; ++e) {
+            if (!std::binary_search(seen.begin(), seen.end(), e)) fresh.push_back(e);
+            if (e == band.last) break;
+        }
+        return fresh;
+    }
+    // draws that repeat an encoding are dropped, so the band is wider than
+    // its samples and the loop ends
+    std::vector<uint64_t> seen;
+    for (const auto& s : band.samples) seen.push_back(s.encoding);
+    std::sort(seen.begin(), seen.end());
+    const uint64_t stream = (band.first ^ (uint64_t(band.depth) << 56)) * 0x9E3779B97F4A7C15ull;
+    for (uint64_t j = band.samples.size(); band.samples.size() + fresh.size() < samples; ++j) {
+        auto r = rng(stream + j);
+        const uint64_t e = band.first + ((uint64_t(r[0]) << 32 | r[1]) % band.width());
+        auto at = std::lower_bound(seen.begin(), seen.end(), e);
+        if (at != seen.end() && *at == e) continue;
+        seen.insert(at, e);
+        fresh.push_back(e);
+    }
+    return fresh;
+}
+
+} // namespace adaptive_detail
+
+// Error map of T over its positive encodings; evaluate(inputs, ulps) sets
+// ulps[i] to the error on inputs[i], infinite where the kernel threw, and
+// is called once per round with every input of that round
+template <typename T, typename Evaluate>
+adaptive_result adaptive_sweep(Evaluate evaluate, const adaptive_options& options = {}) {
+    using word = encoding_word_t<T>;
+    adaptive_result result;
+    error_band root;
+    root.first = encode(next_up(T(0)));
+    root.last = encode(std::numeric_limits<T>::max());
+    result.encodings = root.width();
+    const philox4x32 rng(options.seed, 4);
+    const unsigned fanout = std::max(2u, options.fanout);
+    // a budget below the first grid thins its samples, down to one per band,
+    // and then the grid to one band per call
+    const unsigned grid = static_cast<unsigned>(std::max<uint64_t>(1, std::min<uint64_t>(options.grid, options.budget)));
+    const unsigned samples = static_cast<unsigned>(std::max<uint64_t>(1, std::min<uint64_t>(options.samples, options.budget / grid)));
+
+    // evaluate the encodings the given bands still need, as one batch
+    auto sample = [&](std::vector<error_band*>& pending) {
+        std::vector<std::pair<error_band*, uint64_t>> owners;
+        std::vector<T> inputs;
+        for (error_band* band : pending) {
+            for (uint64_t e : adaptive_detail::fresh_encodings(*band, samples, rng)) {
+                owners.emplace_back(band, e);
+                inputs.push_back(decode<T>(static_cast<word>(e)));
+            }
+        }
+        std::vector<double> ulps(inputs.size(), 0.0);
+        if (!inputs.empty()) evaluate(inputs, ulps);
+        for (size_t i = 0; i < owners.size(); ++i) owners[i].first->samples.push_back({ owners[i].second, ulps[i] });
+        for (error_band* band : pending) {
+            std::sort(band->samples.begin(), band->samples.end(), [](const error_sample& a, const error_sample& b) { return a.encoding < b.encoding; });
+        }
+        result.calls += inputs.size();
+    };
+    // calls a band still needs; its samples are distinct encodings
+    auto cost = [&](const error_band& band) -> uint64_t {
+        const uint64_t target = std::min<uint64_t>(band.width(), samples);
+        return target > band.samples.size() ? target - band.samples.size() : 0;
+    };
+
+    result.bands = adaptive_detail::split(root, grid);
+    for (auto& band : result.bands) band.depth = 0;
+    {
+        std::vector<error_band*> pending;
+        for (auto& band : result.bands) pending.push_back(&band);
+        sample(pending);
+    }
+
+    for (;;) {
+        // bands above a threshold, worst first
+        std::vector<size_t> candidates;
+        for (size_t i = 0; i < result.bands.size(); ++i) {
+            const error_band& band = result.bands[i];
+            if (!band.exhaustive && (band.max_ulp() > options.max_ulp || band.stddev() > options.max_stddev)) candidates.push_back(i);
+        }
+        std::stable_sort(candidates.begin(), candidates.end(), [&](size_t a, size_t b) {
+            return result.bands[a].max_ulp() > result.bands[b].max_ulp();
+        });
+
+        // split while the round fits the budget
+        std::vector<std::vector<error_band>> children(result.bands.size());
+        uint64_t round_cost = 0;
+        bool split_any = false;
+        for (size_t i : candidates) {
+            std::vector<error_band> parts = adaptive_detail::split(result.bands[i], fanout);
+            uint64_t c = 0;
+            for (const auto& part : parts) c += cost(part);
+            if (result.calls + round_cost + c > options.budget) break;
+            round_cost += c;
+            children[i] = std::move(parts);
+            split_any = true;
+        }
+        if (!split_any) break;
+
+        std::vector<error_band> bands;
+        for (size_t i = 0; i < result.bands.size(); ++i) {
+            if (children[i].empty()) bands.push_back(std::move(result.bands[i]));
+            else for (auto& part : children[i]) bands.push_back(std::move(part));
+        }
+        result.bands = std::move(bands);
+        std::vector<error_band*> pending;
+        for (auto& band : result.bands) {
+            if (cost(band) > 0 || (band.width() <= samples && !band.exhaustive)) pending.push_back(&band);
+        }
+        sample(pending);
+        ++result.rounds;
+    }
+    return result;
+}
+
+// Error map of kernel on T: ulps of the kernel's roots against the correctly rounded ones
+template <typename T, typename Kernel>
+adaptive_result adaptive_sweep_kernel(const Kernel& kernel, const adaptive_options& options = {}) {
+    return adaptive_sweep<T>([&](const std::vector<T>& inputs, std::vector<double>& ulps) {
+        for (size_t i = 0; i < inputs.size(); ++i) {
+            try {
+                double ulp = ulp_error(kernel(inputs[i]), inputs[i]);
+                ulps[i] = std::isnan(ulp) ? std::numeric_limits<double>::infinity() : ulp;
+            } catch (const std::exception&) {
+                ulps[i] = std::numeric_limits<double>::infinity();
+            }
+        }
+    }, options);
+}
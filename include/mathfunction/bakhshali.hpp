@@ -0,0 +1,36 @@
+#pragma once
+// bakhshali.hpp: Bakhshali square root iteration
+//
+// The iteration stops as soon as the next step would land within an ulp of
+// the root and leaves the last ulps to the exact-residual finisher
+// (exact_residual.hpp), so the result is correctly rounded in every type.
+// The tolerance is relative to the root.
+#include <cmath>
+#include <universal/number/posit/posit.hpp>
+#include <universal/number/fixpnt/fixpnt.hpp>
+#include <mathfunction/exact_residual.hpp>
+
+// Bakhshali square root function
+template <typename T>
+T bakhshaliSqrt(T S, T initialGuess = T(1.0), T tolerance = T(1e-10), int maxIterations = 1000) {
+    T x = initialGuess;
+    const double relative_tolerance = static_cast<double>(tolerance);
+    int iterations = 0;
+
+    while (iterations < maxIterations) {
+        // (S - x^2) / 2x and a^2 / 2b, arranged so that no square overflows
+        T a = (S / x - x) / T(2.0);
+        T b = x + a;
+        x = b - a * (a / (T(2.0) * b));
+
+        // the error after a correction of relative size r is about r^4 / 8
+        double r = static_cast<double>(a) / static_cast<double>(x);
+        if (std::abs(r) < relative_tolerance || within_rounding_reach(x, r * r * r * r / 8)) {
+            break;
+        }
+
+        iterations++;
+    }
+
+    return round_sqrt(S, x);
+}
@@ -0,0 +1,19 @@
+#pragma once
+// basic.hpp: the square root each number system provides
+#include <cmath>
+#include <mathfunction/number_traits.hpp>
+
+// Template square root calculation
+template <typename T>
+T calculate_sqrt(T value) {
+    if constexpr (is_posit_v<T>) {
+        return sqrt(value);
+    } else if constexpr (is_fixpnt_v<T>) {
+        if (value < 0) {
+            throw sw::universal::fixpnt_arithmetic_exception("argument to sqrt is negative");
+        }
+        return sw::universal::sqrt(value);
+    } else {
+        return sqrt(value);
+    }
+}
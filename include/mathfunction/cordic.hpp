@@ -0,0 +1,36 @@
+#pragma once
+// cordic.hpp: bit-by-bit square root, one result bit per step
+#include <stdexcept>
+#include <universal/number/posit/posit.hpp>
+#include <universal/number/fixpnt/fixpnt.hpp>
+
+template <typename T>
+T cordicSqrt(T x) {
+    if (x < T(0)) {
+        throw std::domain_error("Negative input not allowed");
+    }
+    if (x == T(0)) {
+        return T(0);
+    }
+
+    // Initialize result and iteration variable
+    T result = T(0);
+    T step = x; // Start with the value itself as the step
+
+    while (step > T(1)) {
+        step = step / T(2);
+    }
+
+    while (step != T(0)) {
+        T temp = result + step;
+        if (temp * temp <= x) {
+            result = temp;
+        }
+        // posits round below minpos up to minpos, so the step never reaches zero
+        T half = step / T(2);
+        if (half == step) break;
+        step = half;
+    }
+
+    return result;
+}
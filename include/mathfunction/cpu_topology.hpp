@@ -0,0 +1,160 @@
+#pragma once
+// cpu_topology.hpp: NUMA nodes of the host and the CPUs of each, read from /sys
+//
+// Only the CPUs this process is allowed to run on are kept. A node lists
+// its physical cores first and their SMT siblings after them, so that the
+// first workers placed on a node get a core each. Without
+// /sys/devices/system/node (other kernels, some containers) the host is a
+// single node of every allowed CPU; nodes with memory but no allowed CPU
+// are left out.
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+// CPU numbers of a /sys cpulist such as "0-3,8,10-11"
+inline std::vector<unsigned> parse_cpulist(const std::string& list) {
+    std::vector<unsigned> cpus;
+    std::stringstream ranges(list);
+    std::string range;
+    while (std::getline(ranges, range, ',')) {
+        range.erase(std::remove_if(range.begin(), range.end(), [](char c) { return std::isspace(static_cast<unsigned char>(c)); }), range.end());
+        if (range.empty()) continue;
+        size_t dash = range.find('-');
+        unsigned first = static_cast<unsigned>(std::stoul(range.substr(0, dash)));
+        unsigned last = (dash == std::string::npos) ? first : static_cast<unsigned>(std::stoul(range.substr(dash + 1)));
+        if (last < first) throw std::invalid_argument("cpulist range " + range + " runs backwards");
+        for (unsigned cpu = first; cpu <= last; ++cpu) cpus.push_back(cpu);
+    }
+    return cpus;
+}
+
+// CPUs of the affinity mask of this process, or all of them where there is none
+inline std::vector<unsigned> allowed_cpus() {
+    std::vector<unsigned> cpus;
+#ifdef __linux__
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    if (sched_getaffinity(0, sizeof(mask), &mask) == 0) {
+        for (unsigned cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &mask)) cpus.push_back(cpu);
+        }
+    }
+#endif
+    if (cpus.empty()) {
+        for (unsigned cpu = 0; cpu < std::max(1u, std::thread::hardware_concurrency()); ++cpu) cpus.push_back(cpu);
+    }
+    return cpus;
+}
+
+// Restrict the calling thread to the given CPUs; false where that is not supported or refused
+inline bool pin_current_thread(const std::vector<unsigned>& cpus) {
+#ifdef __linux__
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    for (unsigned cpu : cpus) {
+        if (cpu < CPU_SETSIZE) CPU_SET(cpu, &mask);
+    }
+    return !cpus.empty() && pthread_setaffinity_np(pthread_self(), sizeof(mask), &mask) == 0;
+#else
+    (void)cpus;
+    return false;
+#endif
+}
+
+struct numa_node {
+    unsigned id = 0;
+    std::vector<unsigned> cpus;        // physical cores first, then their SMT siblings
+    std::vector<unsigned> distance;    // /sys distance to node id i, 10 to itself
+};
+
+struct cpu_topology {
+    std::vector<numa_node> nodes;
+
+    size_t cpu_count() const {
+        size_t count = 0;
+        for (const auto& node : nodes) count += node.cpus.size();
+        return count;
+    }
+
+    // Relative distance between the nodes at two positions of nodes
+    unsigned distance(size_t from, size_t to) const {
+        const auto& d = nodes[from].distance;
+        unsigned id = nodes[to].id;
+        if (id < d.size()) return d[id];
+        return (from == to) ? 10 : 20;
+    }
+
+    // Positions of the other nodes, nearest to the node at position from first
+    std::vector<size_t> neighbours(size_t from) const {
+        std::vector<size_t> order;
+        for (size_t to = 0; to < nodes.size(); ++to) {
+            if (to != from) order.push_back(to);
+        }
+        std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return distance(from, a) < distance(from, b); });
+        return order;
+    }
+
+    // One node of the given CPUs
+    static cpu_topology single_node(std::vector<unsigned> cpus) {
+        cpu_topology topology;
+        topology.nodes.push_back({ 0, std::move(cpus), { 10 } });
+        return topology;
+    }
+
+    // The nodes under sys_root/node, restricted to the allowed CPUs
+    static cpu_topology detect(const std::string& sys_root = "/sys/devices/system", const std::vector<unsigned>& allowed = allowed_cpus()) {
+        namespace fs = std::filesystem;
+        auto read_line = [](const fs::path& path) {
+            std::ifstream file(path);
+            std::string line;
+            std::getline(file, line);
+            return line;
+        };
+
+        cpu_topology topology;
+        std::error_code ec;
+        const fs::path node_root = fs::path(sys_root) / "node";
+        for (fs::directory_iterator it(node_root, ec), end; !ec && it != end; it.increment(ec)) {
+            const std::string name = it->path().filename().string();
+            if (name.size() <= 4 || name.compare(0, 4, "node") != 0 || !std::all_of(name.begin() + 4, name.end(), [](char c) { return std::isdigit(static_cast<unsigned char>(c)) != 0; })) continue;
+
+            numa_node node;
+            node.id = static_cast<unsigned>(std::stoul(name.substr(4)));
+            for (unsigned cpu : parse_cpulist(read_line(it->path() / "cpulist"))) {
+                if (std::find(allowed.begin(), allowed.end(), cpu) != allowed.end()) node.cpus.push_back(cpu);
+            }
+            if (node.cpus.empty()) continue;
+            std::stringstream distances(read_line(it->path() / "distance"));
+            for (unsigned d; distances >> d;) node.distance.push_back(d);
+
+            // a CPU is the core itself when it is the first of its siblings
+            auto sibling_rank = [&](unsigned cpu) {
+                fs::path list = fs::path(sys_root) / "cpu" / ("cpu" + std::to_string(cpu)) / "topology" / "thread_siblings_list";
+                std::vector<unsigned> siblings = parse_cpulist(read_line(list));
+                auto position = std::find(siblings.begin(), siblings.end(), cpu);
+                return (position == siblings.end()) ? 0 : static_cast<unsigned>(position - siblings.begin());
+            };
+            std::vector<std::pair<unsigned, unsigned>> ranked;
+            for (unsigned cpu : node.cpus) ranked.emplace_back(sibling_rank(cpu), cpu);
+            std::stable_sort(ranked.begin(), ranked.end());
+            for (size_t i = 0; i < ranked.size(); ++i) node.cpus[i] = ranked[i].second;
+
+            topology.nodes.push_back(std::move(node));
+        }
+        if (topology.nodes.empty()) return single_node(allowed);
+        std::sort(topology.nodes.begin(), topology.nodes.end(), [](const numa_node& a, const numa_node& b) { return a.id < b.id; });
+        return topology;
+    }
+};
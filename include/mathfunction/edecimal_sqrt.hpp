@@ -0,0 +1,105 @@
+#pragma once
+// edecimal_sqrt.hpp: integer square roots of arbitrary-precision edecimals
+//
+// edecimalSqrt doubles the working precision on the way up: the root of the
+// leading half of the digits seeds a single Newton step on the full number.
+// Only the last step runs at full length, so the total cost is a constant
+// times one full-length multiply/divide, instead of one per iteration as in
+// fixedNewtonSqrt.
+#include <stdexcept>
+#include <string>
+#include <universal/number/edecimal/edecimal.hpp>
+
+// 10^digits
+inline sw::universal::edecimal edecimal_power_of_ten(int digits) {
+    sw::universal::edecimal p;
+    p = 1;
+    p.shiftLeft(digits);
+    return p;
+}
+
+// Number of significant decimal digits
+inline int edecimal_digits(sw::universal::edecimal n) {
+    n.unpad();
+    return static_cast<int>(n.size());
+}
+
+// floor(sqrt(n)) by Newton iteration at full length from a seed above the root
+inline sw::universal::edecimal fixedNewtonSqrt(const sw::universal::edecimal& n) {
+    using sw::universal::edecimal;
+    if (n.sign() && !n.iszero()) {
+        throw std::domain_error("Negative input not allowed");
+    }
+    if (n.iszero()) {
+        return n;
+    }
+    edecimal two;
+    two = 2;
+    // 10^ceil(d/2) > sqrt(n), and from above the iterates decrease monotonically to the floor
+    edecimal x = edecimal_power_of_ten((edecimal_digits(n) + 1) / 2);
+    while (true) {
+        edecimal y = (x + n / x) / two;
+        if (y >= x) {
+            break;
+        }
+        x = y;
+    }
+    x.unpad();
+    return x;
+}
+
+// floor(sqrt(n)) with precision doubling
+inline sw::universal::edecimal edecimalSqrt(const sw::universal::edecimal& n) {
+    using sw::universal::edecimal;
+    if (n.sign() && !n.iszero()) {
+        throw std::domain_error("Negative input not allowed");
+    }
+    const int digits = edecimal_digits(n);
+    if (digits <= 8) {
+        return fixedNewtonSqrt(n);
+    }
+
+    // root of the leading digits: s = isqrt(floor(n / 10^(2h))), accurate to about (d - 2h) / 2 digits
+    const int h = digits / 4;
+    edecimal high = n;
+    high.shiftRight(2 * h);
+    edecimal x = edecimalSqrt(high);
+    x.shiftLeft(h);
+
+    // one Newton step at full length doubles the correct digits
+    edecimal two, one;
+    two = 2;
+    one = 1;
+    if (!x.iszero()) {
+        x = (x + n / x) / two;
+    }
+
+    // the step lands within a unit or two of the floor
+    while (x * x > n) {
+        x = x - one;
+    }
+    while ((x + one) * (x + one) <= n) {
+        x = x + one;
+    }
+    x.unpad();
+    return x;
+}
+
+// sqrt(n) to the given number of decimals, as a decimal string
+inline std::string edecimal_sqrt_digits(const sw::universal::edecimal& n, int decimals) {
+    sw::universal::edecimal scaled = n;
+    scaled.shiftLeft(2 * decimals);
+    sw::universal::edecimal root = edecimalSqrt(scaled);
+
+    std::string text;
+    for (auto it = root.rbegin(); it != root.rend(); ++it) {
+        text.push_back(static_cast<char>('0' + *it));
+    }
+    if (static_cast<int>(text.size()) <= decimals) {
+        text.insert(0, decimals + 1 - text.size(), '0');
+    }
+    if (decimals > 0) {
+        text.insert(text.size() - decimals, ".");
+    }
+    return text;
+}
@@ -0,0 +1,52 @@
+#pragma once
+// encoding.hpp: conversion between the sweep number types and their raw bit encodings
+//
+// Callers outside C++ exchange values as unsigned integers of the type's
+// width: the posit and fixpnt bit patterns, and the IEEE-754 binary32 and
+// binary64 patterns of float and double.
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <mathfunction/number_traits.hpp>
+
+template <unsigned nbits>
+using encoding_word = std::conditional_t<(nbits <= 8), uint8_t,
+                      std::conditional_t<(nbits <= 16), uint16_t,
+                      std::conditional_t<(nbits <= 32), uint32_t, uint64_t>>>;
+
+// Width of the encoding of T in bits
+template <typename T>
+constexpr unsigned encoding_bits() {
+    if constexpr (is_posit_v<T>) return is_posit_type<T>::total_bits;
+    else if constexpr (is_fixpnt_v<T>) return static_cast<unsigned>(is_fixpnt_type<T>::total_bits);
+    else return 8 * sizeof(T);
+}
+
+template <typename T>
+using encoding_word_t = encoding_word<encoding_bits<T>()>;
+
+template <typename T>
+T decode(encoding_word_t<T> bits) {
+    T value{};
+    if constexpr (std::is_floating_point_v<T>) {
+        std::memcpy(&value, &bits, sizeof(T));
+    } else {
+        value.setbits(bits);
+    }
+    return value;
+}
+
+template <typename T>
+encoding_word_t<T> encode(const T& value) {
+    encoding_word_t<T> bits = 0;
+    if constexpr (std::is_floating_point_v<T>) {
+        std::memcpy(&bits, &value, sizeof(T));
+    } else if constexpr (is_posit_v<T>) {
+        bits = static_cast<encoding_word_t<T>>(value.get().to_ullong());
+    } else {
+        for (unsigned i = 0; i < encoding_bits<T>(); ++i) {
+            if (value.at(i)) bits |= encoding_word_t<T>(1) << i;
+        }
+    }
+    return bits;
+}
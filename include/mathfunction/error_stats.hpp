@@ -0,0 +1,248 @@
+#pragma once
+// error_stats.hpp: streaming, mergeable statistics of per-input ULP errors
+//
+// One error_stats per (algorithm, type, range) holds the exact maximum with
+// its argument, mean and variance, a histogram of ULP errors and a t-digest
+// for quantiles, all in memory bounded independently of the number of
+// inputs. Mean and variance follow Welford's update and Chan's pairwise
+// merge, so chunks processed on different threads combine into the same
+// moments as one sequential pass, up to rounding; the histogram merges
+// exactly and the digest to within its compression.
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <limits>
+#include <numbers>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Counts of ULP errors in fixed buckets: [0, 0.5] (within half an ulp),
+// (0.5, 1], quarter octaves from 1 to 2^max_octave, and everything above,
+// infinities included
+class ulp_histogram {
+public:
+    static constexpr int max_octave = 32;
+    static constexpr int steps_per_octave = 4;
+    static constexpr size_t bucket_count = 2 + max_octave * steps_per_octave + 1;
+
+    void record(double ulp) {
+        ++counts[bucket_index(ulp)];
+    }
+
+    void merge(const ulp_histogram& rhs) {
+        for (size_t i = 0; i < bucket_count; ++i) counts[i] += rhs.counts[i];
+    }
+
+    uint64_t count(size_t bucket) const { return counts[bucket]; }
+
+    // Inclusive upper bound of a bucket's ULP errors
+    static double bucket_upper(size_t bucket) {
+        if (bucket == 0) return 0.5;
+        if (bucket == 1) return 1.0;
+        if (bucket == bucket_count - 1) return std::numeric_limits<double>::infinity();
+        return std::exp2(static_cast<double>(bucket - 1) / steps_per_octave);
+    }
+
+    static size_t bucket_index(double ulp) {
+        if (ulp <= 0.5) return 0;
+        if (ulp <= 1.0) return 1;
+        if (!(ulp <= std::exp2(max_octave))) return bucket_count - 1;
+        // smallest bucket whose upper bound holds ulp
+        size_t b = 1 + static_cast<size_t>(std::ceil(std::log2(ulp) * steps_per_octave));
+        while (b > 2 && bucket_upper(b - 1) >= ulp) --b;
+        while (bucket_upper(b) < ulp) ++b;
+        return b;
+    }
+
+private:
+    std::array<uint64_t, bucket_count> counts{};
+};
+
+// Merging t-digest (Dunning): samples are buffered and periodically folded
+// into at most about compression centroids, sized by the arcsine scale
+// function so the tails stay fine-grained. Memory is bounded by the
+// compression, not by the number of samples.
+class t_digest {
+public:
+    t_digest() = default;
+    explicit t_digest(double compression) : compression(compression) {}
+
+    void add(double x, double weight = 1.0) {
+        if (std::isnan(x)) return;
+        buffer.push_back({ x, weight });
+        min_value = std::min(min_value, x);
+        max_value = std::max(max_value, x);
+        if (buffer.size() >= buffer_capacity()) compress();
+    }
+
+    void merge(const t_digest& rhs) {
+        for (const auto& c : rhs.centroids) {
+            buffer.push_back(c);
+            if (buffer.size() >= buffer_capacity()) compress();
+        }
+        for (const auto& c : rhs.buffer) {
+            buffer.push_back(c);
+            if (buffer.size() >= buffer_capacity()) compress();
+        }
+        min_value = std::min(min_value, rhs.min_value);
+        max_value = std::max(max_value, rhs.max_value);
+    }
+
+    double total_weight() const {
+        double w = 0.0;
+        for (const auto& c : centroids) w += c.weight;
+        for (const auto& c : buffer) w += c.weight;
+        return w;
+    }
+
+    size_t centroid_count() const { return centroids.size(); }
+
+    // Value below which the fraction q of the samples lies, interpolated
+    // between centroid centres; 0 when empty
+    double quantile(double q) const {
+        if (!buffer.empty()) {
+            t_digest folded(*this);
+            folded.compress();
+            return folded.quantile(q);
+        }
+        if (centroids.empty()) return 0.0;
+        q = std::clamp(q, 0.0, 1.0);
+        double total = 0.0;
+        for (const auto& c : centroids) total += c.weight;
+        const double target = q * total;
+
+        double cumulative = 0.0;
+        double previous_centre = 0.0, previous_mean = min_value;
+        for (const auto& c : centroids) {
+            double centre = cumulative + c.weight / 2.0;
+            if (target < centre) {
+                // a centroid of one sample is that sample
+                if (c.weight == 1.0 && target >= cumulative) return c.mean;
+                return interpolate(previous_mean, c.mean, (target - previous_centre) / (centre - previous_centre));
+            }
+            cumulative += c.weight;
+            previous_centre = centre;
+            previous_mean = c.mean;
+        }
+        return interpolate(previous_mean, max_value, (target - previous_centre) / (total - previous_centre));
+    }
+
+private:
+    struct centroid {
+        double mean;
+        double weight;
+    };
+
+    size_t buffer_capacity() const { return static_cast<size_t>(5.0 * compression); }
+
+    // k1 scale: centroids span at most one unit of k
+    double scale(double q) const { return compression / (2.0 * std::numbers::pi) * std::asin(2.0 * q - 1.0); }
+    double inverse_scale(double k) const { return (std::sin(std::min(k * 2.0 * std::numbers::pi / compression, std::numbers::pi / 2.0)) + 1.0) / 2.0; }
+
+    static double interpolate(double a, double b, double t) {
+        if (t <= 0.0 || a == b) return a;
+        if (t >= 1.0) return b;
+        return a + (b - a) * t;
+    }
+
+    void compress() {
+        buffer.insert(buffer.end(), centroids.begin(), centroids.end());
+        std::sort(buffer.begin(), buffer.end(), [](const centroid& a, const centroid& b) { return a.mean < b.mean; });
+        double total = 0.0;
+        for (const auto& c : buffer) total += c.weight;
+
+        centroids.clear();
+        double so_far = 0.0;
+        double limit = inverse_scale(scale(0.0) + 1.0) * total;
+        centroid current = buffer.front();
+        for (size_t i = 1; i < buffer.size(); ++i) {
+            const centroid& c = buffer[i];
+            if (so_far + current.weight + c.weight <= limit) {
+                // weighted mean written so an infinite error stays infinite
+                current.mean = (current.mean * current.weight + c.mean * c.weight) / (current.weight + c.weight);
+                if (std::isnan(current.mean)) current.mean = c.mean;
+                current.weight += c.weight;
+            } else {
+                so_far += current.weight;
+                limit = inverse_scale(scale(so_far / total) + 1.0) * total;
+                centroids.push_back(current);
+                current = c;
+            }
+        }
+        centroids.push_back(current);
+        buffer.clear();
+    }
+
+    double compression = 100.0;
+    std::vector<centroid> centroids;   // sorted by mean
+    std::vector<centroid> buffer;      // samples not yet folded in
+    double min_value = std::numeric_limits<double>::infinity();
+    double max_value = -std::numeric_limits<double>::infinity();
+};
+
+struct error_stats {
+    uint64_t count = 0;       // inputs measured
+    uint64_t skipped = 0;     // inputs outside the domain of the type (zero, negative, NaR)
+    uint64_t failures = 0;    // inputs the kernel threw on
+    double max_ulp = 0.0;
+    double max_ulp_argument = 0.0;
+    double mean = 0.0;
+    double m2 = 0.0;          // sum of squared deviations from the mean
+    ulp_histogram histogram;
+    t_digest digest;
+
+    void add(double ulp, double argument) {
+        if (count == 0 || ulp > max_ulp) {
+            max_ulp = ulp;
+            max_ulp_argument = argument;
+        }
+        ++count;
+        double delta = ulp - mean;
+        mean += delta / static_cast<double>(count);
+        m2 += delta * (ulp - mean);
+        histogram.record(ulp);
+        digest.add(ulp);
+    }
+
+    void merge(const error_stats& rhs) {
+        skipped += rhs.skipped;
+        failures += rhs.failures;
+        if (rhs.count == 0) return;
+        if (count == 0 || rhs.max_ulp > max_ulp) {
+            max_ulp = rhs.max_ulp;
+            max_ulp_argument = rhs.max_ulp_argument;
+        }
+        double n = static_cast<double>(count), m = static_cast<double>(rhs.count);
+        double delta = rhs.mean - mean;
+        mean += delta * m / (n + m);
+        m2 += rhs.m2 + delta * delta * n * m / (n + m);
+        count += rhs.count;
+        histogram.merge(rhs.histogram);
+        digest.merge(rhs.digest);
+    }
+
+    double variance() const {
+        return count > 1 ? m2 / static_cast<double>(count - 1) : 0.0;
+    }
+
+    // Approximate ULP error below which the fraction q of the inputs lies; exact at q = 1
+    double quantile(double q) const {
+        return q >= 1.0 ? max_ulp : digest.quantile(q);
+    }
+
+    // Fraction of the measured inputs within half an ulp
+    double within_half_ulp() const {
+        return count > 0 ? static_cast<double>(histogram.count(0)) / static_cast<double>(count) : 0.0;
+    }
+};
+
+// An argument in full for the csv files: std::to_string formats with %f,
+// which writes every argument below 5e-7 as 0.000000
+inline std::string argument_text(double x) {
+    std::ostringstream text;
+    text << std::setprecision(17) << x;
+    return text.str();
+}
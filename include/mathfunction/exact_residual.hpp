@@ -0,0 +1,151 @@
+#pragma once
+// exact_residual.hpp: correct rounding of a square root from its exact residual
+//
+// y is sqrt(x) rounded to nearest when x lies between the squares of the
+// midpoints y shares with its two neighbours, so the sign of
+// 4x - (lo + hi)^2 for neighbours lo < hi decides the rounding. That
+// residual is formed without any rounding: posits accumulate the products
+// in the quire, fixpnt multiplies the integers behind the encodings, and
+// IEEE types scale y near 1 and keep the sum of exact products (fma
+// two-product, two-sum) as a floating-point expansion. A square root is
+// never exactly a midpoint, so the sign is never zero for the roots of
+// representable inputs.
+//
+// Posits round at the midpoint of the encodings, which is the arithmetic
+// midpoint as long as the value keeps fraction bits; square roots halve the
+// scale, so the roots of posit<16,2> and posit<32,2> always keep some.
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+#include <mathfunction/number_traits.hpp>
+#include <mathfunction/range_reduction.hpp>
+#include <mathfunction/ulp.hpp>
+
+// Steps of one ulp that round_sqrt takes at most; iterations that are
+// stopped within rounding reach leave their result a few ulps away
+constexpr int round_sqrt_max_steps = 64;
+
+// a + b = s + e exactly
+inline void two_sum(double a, double b, double& s, double& e) {
+    s = a + b;
+    double bb = s - a;
+    e = (a - (s - bb)) + (b - bb);
+}
+
+// a * b = p + e exactly, barring underflow
+inline void two_product(double a, double b, double& p, double& e) {
+    p = a * b;
+    e = std::fma(a, b, -p);
+}
+
+// Sign of the exact sum of n doubles, grown one term at a time into a
+// non-overlapping expansion whose largest nonzero component carries the sign
+inline int exact_sum_sign(const double* terms, int n) {
+    double expansion[16];
+    int length = 0;
+    for (int t = 0; t < n && length < 16; ++t) {
+        double q = terms[t];
+        for (int i = 0; i < length; ++i) two_sum(q, expansion[i], q, expansion[i]);
+        expansion[length++] = q;
+    }
+    for (int i = length - 1; i >= 0; --i) {
+        if (expansion[i] != 0.0) return expansion[i] > 0.0 ? 1 : -1;
+    }
+    return 0;
+}
+
+// Sign of 4x - (lo + hi)^2, that is of x minus the square of the midpoint of lo and hi > 0
+template <typename T>
+int sqrt_midpoint_residual(const T& x, const T& lo, const T& hi) {
+    if constexpr (is_posit_v<T>) {
+        using Quire = sw::universal::quire<is_posit_type<T>::total_bits, is_posit_type<T>::exponent_bits>;
+        Quire q(0);
+        q += sw::universal::quire_mul(x, T(4));
+        q -= sw::universal::quire_mul(lo, lo);
+        q -= sw::universal::quire_mul(lo, hi);
+        q -= sw::universal::quire_mul(lo, hi);
+        q -= sw::universal::quire_mul(hi, hi);
+        return q.iszero() ? 0 : (q.sign() ? -1 : 1);
+    } else if constexpr (is_fixpnt_v<T>) {
+        // x = X 2^-f and y = Y 2^-f: compare 4 X 2^f with (L + H)^2
+        static_assert(is_fixpnt_type<T>::total_bits <= 48, "the residual of wider fixpnt formats needs more than 128 bits");
+        using wide = __int128;
+        wide lhs = wide(4) * wide(fixpnt_raw(x)) << is_fixpnt_type<T>::fraction_bits;
+        wide sum = wide(fixpnt_raw(lo)) + wide(fixpnt_raw(hi));
+        wide rhs = sum * sum;
+        return (lhs > rhs) - (lhs < rhs);
+    } else {
+        // hi scaled into [1, 2) and x by the square of that power of two, exactly
+        const int e = std::ilogb(hi);
+        const double x_scaled = std::ldexp(static_cast<double>(x), -2 * e);
+        const double lo_scaled = std::ldexp(static_cast<double>(lo), -e);
+        const double hi_scaled = std::ldexp(static_cast<double>(hi), -e);
+        double terms[7];
+        terms[0] = 4.0 * x_scaled;
+        two_product(-lo_scaled, lo_scaled, terms[1], terms[2]);
+        two_product(-2.0 * lo_scaled, hi_scaled, terms[3], terms[4]);
+        two_product(-hi_scaled, hi_scaled, terms[5], terms[6]);
+        return exact_sum_sign(terms, 7);
+    }
+}
+
+// A neighbour that T can round a positive square root to
+template <typename T>
+bool usable_neighbour(const T& neighbour, const T& y) {
+    if (!(neighbour > T(0)) || neighbour == y) return false;
+    if constexpr (std::is_floating_point_v<T>) return std::isfinite(neighbour);
+    return true;
+}
+
+// y, a root near sqrt(x), moved to sqrt(x) rounded to nearest; y stays as it
+// is for x <= 0, NaN or NaR, and for a y that is not a positive finite value
+template <typename T>
+T round_sqrt(const T& x, T y) {
+    if (!(x > T(0)) || !(y > T(0))) return y;
+    if constexpr (std::is_floating_point_v<T>) {
+        if (!std::isfinite(x) || !std::isfinite(y)) return y;
+    }
+    for (int step = 0; step < round_sqrt_max_steps; ++step) {
+        T up = next_up(y);
+        if (up > y && usable_neighbour(up, y) && sqrt_midpoint_residual(x, y, up) > 0) {
+            y = up;
+            continue;
+        }
+        T down = next_down(y);
+        if (down < y && usable_neighbour(down, y) && sqrt_midpoint_residual(x, down, y) < 0) {
+            y = down;
+            continue;
+        }
+        break;
+    }
+    return y;
+}
+
+// True when y is sqrt(x) rounded to nearest, decided on the exact residuals
+// rather than on a reference root in a wider type
+template <typename T>
+bool is_correctly_rounded_sqrt(const T& x, const T& y) {
+    if (x == T(0)) return y == T(0);
+    if (!(x > T(0)) || !(y > T(0))) return false;
+    T up = next_up(y), down = next_down(y);
+    if (up > y && usable_neighbour(up, y) && sqrt_midpoint_residual(x, y, up) > 0) return false;
+    if (down < y && usable_neighbour(down, y) && sqrt_midpoint_residual(x, down, y) < 0) return false;
+    return true;
+}
+
+// True when an iterate x whose relative error is estimated at relative_error
+// is within an ulp of the root, so that round_sqrt can finish it. The ulp is
+// that of the densest part of the type, 2^-precision relative, or 2^-rbits
+// absolute for fixpnt, so the test costs no conversion of an ulp per iteration
+template <typename T>
+bool within_rounding_reach(const T& x, double relative_error) {
+    if (!(x > T(0))) return false;
+    if constexpr (is_fixpnt_v<T>) {
+        return relative_error * static_cast<double>(x) <= std::ldexp(1.0, -is_fixpnt_type<T>::fraction_bits);
+    } else {
+        static const double densest_ulp = std::ldexp(1.0, 1 - precision_bits<T>());
+        return relative_error <= densest_ulp;
+    }
+}
@@ -0,0 +1,19 @@
+#pragma once
+// exp_identity.hpp: sqrt(S) = exp(log(S) / 2), evaluated in double
+#include <cmath>
+#include <stdexcept>
+#include <universal/number/posit/posit.hpp>
+#include <universal/number/fixpnt/fixpnt.hpp>
+
+template <typename T>
+T expSqrt(T S) {
+    // Avoiding negative values
+    if (S < 0) {
+        throw std::runtime_error("Negative value encountered in expSqrt");
+    }
+    // Convert to double for log and exp calculations
+    double S_double = static_cast<double>(S);
+    double result_double = std::exp(0.5 * std::log(S_double));
+    // Convert back to the original type if necessary
+    return static_cast<T>(result_double);
+}
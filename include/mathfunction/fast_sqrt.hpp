@@ -0,0 +1,43 @@
+#pragma once
+// fast_sqrt.hpp: sqrt dispatched per exponent bucket to the fastest kernel meeting the accuracy target
+//
+// The dispatch tables are measured on the build machine by the
+// sqrt_dispatch tool into the generated sqrt_dispatch_table.hpp, which
+// every target reaching this header depends on. A type without a table
+// uses calculate_sqrt everywhere, with no measured error bound.
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <mathfunction/sqrt_algorithm.hpp>
+
+// Bucket b covers the binary exponents [min_exponent + b * bucket_width, min_exponent + (b + 1) * bucket_width)
+template <typename T>
+struct sqrt_dispatch {
+    static constexpr int min_exponent = 0;
+    static constexpr int bucket_width = 1;
+    static constexpr int buckets = 1;
+    static constexpr double max_ulp = std::numeric_limits<double>::infinity();   // not measured
+    static constexpr sqrt_algorithm kernel[] = { sqrt_algorithm::basic };
+};
+
+#include <mathfunction/sqrt_dispatch_table.hpp>
+
+// Dispatch bucket of a positive x; exponents outside the table use its end buckets
+template <typename T>
+int sqrt_dispatch_bucket(const T& x) {
+    using table = sqrt_dispatch<T>;
+    int e = std::max(binary_exponent(x), table::min_exponent);
+    return std::min((e - table::min_exponent) / table::bucket_width, table::buckets - 1);
+}
+
+template <typename T>
+T fast_sqrt(T x) {
+    if (x < T(0)) {
+        throw std::runtime_error("Negative value encountered in fast_sqrt");
+    }
+    if (x == T(0)) {
+        return T(0);
+    }
+
+    return sqrt_with(sqrt_dispatch<T>::kernel[sqrt_dispatch_bucket(x)], x);
+}
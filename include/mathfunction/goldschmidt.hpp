@@ -0,0 +1,113 @@
+#pragma once
+// goldschmidt.hpp: simultaneous sqrt and rsqrt through Goldschmidt iteration
+//
+// From a seed y ~ 1/sqrt(m) the iteration keeps g -> sqrt(m) and
+// h -> 1/(2 sqrt(m)):
+//     r = 1/2 - g*h,   g = g + g*r,   h = h + h*r
+// The two updates are independent multiplications and there is no divide,
+// so a step issues in parallel on a superscalar core, and the batch kernel
+// interleaves several lanes to fill the multiplier pipeline.
+#include <cstddef>
+#include <stdexcept>
+#include <mathfunction/poly_sqrt.hpp>
+#include <mathfunction/remez_coefficients.hpp>
+
+// Seed for 1/sqrt(m) on [1,4): the rsqrt polynomial the remez tool generates
+// at build time, of the degree with the least Horner and iteration cost for T
+template <typename T>
+using goldschmidt_seed = remez_rsqrt<remez_rsqrt_degree(precision_bits<T>())>;
+
+// Iterations needed to reach the precision of T; each one doubles the correct bits
+template <typename T>
+constexpr int goldschmidt_iterations() {
+    return remez_refinements(goldschmidt_seed<T>::bits, precision_bits<T>());
+}
+
+template <typename T>
+T goldschmidt_seed_rsqrt(const T& m) {
+    using table = goldschmidt_seed<T>;
+    T t = m * T(2.0 / (table::hi - table::lo)) - T((table::lo + table::hi) / (table::hi - table::lo));
+    T y = T(table::c[table::degree]);
+    for (int i = table::degree - 1; i >= 0; --i) {
+        y = y * t + T(table::c[i]);
+    }
+    return y;
+}
+
+// Computes sqrt(S) and 1/sqrt(S) together
+template <typename T>
+void goldschmidtSqrtRsqrt(T S, T& sqrtS, T& rsqrtS) {
+    if (S < T(0)) {
+        throw std::domain_error("Negative input not allowed");
+    }
+    if (S == T(0)) {
+        sqrtS = T(0);
+        rsqrtS = T(0); // 1/sqrt(0) is unbounded; callers that need it must test for zero
+        return;
+    }
+
+    int k;
+    T m = sqrt_reduce(S, k);
+    T y = goldschmidt_seed_rsqrt(m);
+    T g = m * y;
+    T h = y * T(0.5);
+    for (int i = 0; i < goldschmidt_iterations<T>(); ++i) {
+        T r = T(0.5) - g * h;
+        g = g + g * r;
+        h = h + h * r;
+    }
+
+    sqrtS = g * power_of_two<T>(k);
+    rsqrtS = (h + h) * power_of_two<T>(-k);
+}
+
+template <typename T>
+T goldschmidtSqrt(T S) {
+    T sqrtS, rsqrtS;
+    goldschmidtSqrtRsqrt(S, sqrtS, rsqrtS);
+    return sqrtS;
+}
+
+template <typename T>
+T goldschmidtRsqrt(T S) {
+    T sqrtS, rsqrtS;
+    goldschmidtSqrtRsqrt(S, sqrtS, rsqrtS);
+    return rsqrtS;
+}
+
+// Batch sqrt: lanes are advanced in groups so that the independent
+// multiplications of neighbouring lanes can overlap
+template <typename T>
+void goldschmidtSqrt(const T* in, T* out, size_t n) {
+    constexpr size_t lanes = 4;
+    size_t i = 0;
+    for (; i + lanes <= n; i += lanes) {
+        T g[lanes], h[lanes], scale[lanes];
+        bool special = false;
+        for (size_t l = 0; l < lanes; ++l) {
+            special = special || !(in[i + l] > T(0));
+        }
+        if (special) {
+            // zero or negative lanes take the scalar path with its checks
+            for (size_t l = 0; l < lanes; ++l) out[i + l] = goldschmidtSqrt(in[i + l]);
+            continue;
+        }
+        for (size_t l = 0; l < lanes; ++l) {
+            int k;
+            T m = sqrt_reduce(in[i + l], k);
+            T y = goldschmidt_seed_rsqrt(m);
+            g[l] = m * y;
+            h[l] = y * T(0.5);
+            scale[l] = power_of_two<T>(k);
+        }
+        for (int step = 0; step < goldschmidt_iterations<T>(); ++step) {
+            for (size_t l = 0; l < lanes; ++l) {
+                T r = T(0.5) - g[l] * h[l];
+                g[l] = g[l] + g[l] * r;
+                h[l] = h[l] + h[l] * r;
+            }
+        }
+        for (size_t l = 0; l < lanes; ++l) out[i + l] = g[l] * scale[l];
+    }
+    for (; i < n; ++i) out[i] = goldschmidtSqrt(in[i]);
+}
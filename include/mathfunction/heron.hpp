@@ -0,0 +1,35 @@
+#pragma once
+// heron.hpp: Babylonian / Heron square root iteration
+//
+// The iteration stops as soon as the next step would land within an ulp of
+// the root and leaves the last ulps to the exact-residual finisher
+// (exact_residual.hpp), so the result is correctly rounded in every type.
+// The tolerance is relative to the root.
+#include <cmath>
+#include <universal/number/posit/posit.hpp>
+#include <universal/number/fixpnt/fixpnt.hpp>
+#include <mathfunction/exact_residual.hpp>
+
+// Babylonian - Heron's square root function
+template <typename T>
+T heronSqrt(T S, T initialGuess = T(1.0), T tolerance = T(1e-10), int maxIterations = 1000) {
+    T x = initialGuess;
+    const double relative_tolerance = static_cast<double>(tolerance);
+    int iterations = 0;
+
+    while (iterations < maxIterations) {
+        // half the way to S / x, without the sum x + S / x that overflows fixpnt near the top of its range
+        T step = (S / x - x) / T(2.0);
+        x = x + step;
+
+        // the error after a step of relative size r is about r^2 / 2
+        double r = static_cast<double>(step) / static_cast<double>(x);
+        if (std::abs(r) < relative_tolerance || within_rounding_reach(x, r * r / 2)) {
+            break;
+        }
+
+        iterations++;
+    }
+
+    return round_sqrt(S, x);
+}
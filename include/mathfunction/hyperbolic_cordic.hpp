@@ -0,0 +1,240 @@
+#pragma once
+// hyperbolic_cordic.hpp: shift-and-add hyperbolic CORDIC for fixpnt: sqrt, ln, exp and atanh
+//
+// One engine, one table. Each iteration i adds or subtracts copies of x and
+// y shifted right by s_i and a table angle atanh(2^-s_i), so the datapath
+// needs an adder and a barrel shifter but no multiplier. The hyperbolic
+// sequence only converges when the shifts 4, 13, 40, ... (s' = 3s + 1) are
+// taken twice. In vectoring mode (y driven to zero) the engine yields
+// K sqrt(x0^2 - y0^2) and z0 + atanh(y0/x0); in rotation mode (z driven to
+// zero) it yields K (cosh z0, sinh z0) scaled by x0 = y0. The gain K and
+// ln 2 are constants, applied by shifted adds of their set bits.
+//
+// The registers are two's complement integers with fraction_bits binary
+// places, more than the type's rbits, in the way a hardware datapath
+// carries guard bits; arguments are brought into the convergence range
+// by shifts (powers of 2 and 4) and results rounded back to the type.
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+#include <universal/number/fixpnt/fixpnt.hpp>
+#include <mathfunction/encoding.hpp>
+
+template <unsigned fraction_bits>
+class hyperbolic_cordic {
+public:
+    static constexpr int64_t one = int64_t(1) << fraction_bits;
+
+    // The ROM: computed once, the way it would be generated for a device
+    static const hyperbolic_cordic& table() {
+        static const hyperbolic_cordic rom;
+        return rom;
+    }
+
+    // Drive y to zero: x = K sqrt(x0^2 - y0^2), z = z0 + atanh(y0 / x0) for |y0 / x0| < 0.8
+    void vectoring(int64_t& x, int64_t& y, int64_t& z) const {
+        for (size_t i = 0; i < shifts.size(); ++i) {
+            int64_t dx = y >> shifts[i], dy = x >> shifts[i];
+            if (y < 0) {
+                x += dx; y += dy; z -= angles[i];
+            } else {
+                x -= dx; y -= dy; z += angles[i];
+            }
+        }
+    }
+
+    // Drive z to zero: x = K (x0 cosh z0 + y0 sinh z0), y = K (y0 cosh z0 + x0 sinh z0) for |z0| < 1.1
+    void rotation(int64_t& x, int64_t& y, int64_t& z) const {
+        for (size_t i = 0; i < shifts.size(); ++i) {
+            int64_t dx = y >> shifts[i], dy = x >> shifts[i];
+            if (z < 0) {
+                x -= dx; y -= dy; z += angles[i];
+            } else {
+                x += dx; y += dy; z -= angles[i];
+            }
+        }
+    }
+
+    // v * c for a positive constant c with fraction_bits places: one shifted copy of v per set bit of c
+    static int64_t scale(int64_t v, int64_t c) {
+        int64_t product = 0;
+        for (unsigned j = 0; j < 63; ++j) {
+            if ((c >> j) & 1) product += (j >= fraction_bits) ? (v << (j - fraction_bits)) : (v >> (fraction_bits - j));
+        }
+        return product;
+    }
+
+    // v * n for an integer n
+    static int64_t times(int64_t v, int64_t n) {
+        int64_t product = 0;
+        uint64_t m = static_cast<uint64_t>(n < 0 ? -n : n);
+        for (unsigned j = 0; m != 0; ++j, m >>= 1) {
+            if (m & 1) product += v << j;
+        }
+        return n < 0 ? -product : product;
+    }
+
+    // v = m 4^e with m in [1/4, 1): returns e and leaves m in v
+    static int normalize4(int64_t& v) {
+        int s = std::bit_width(static_cast<uint64_t>(v)) - static_cast<int>(fraction_bits);
+        int e = (s + 1) >> 1;
+        v = (e >= 0) ? (v >> (2 * e)) : (v << (-2 * e));
+        return e;
+    }
+
+    // v = m 2^e with m in [1/2, 1): returns e and leaves m in v
+    static int normalize2(int64_t& v) {
+        int e = std::bit_width(static_cast<uint64_t>(v)) - static_cast<int>(fraction_bits);
+        v = (e >= 0) ? (v >> e) : (v << -e);
+        return e;
+    }
+
+    // sqrt(v) for v > 0
+    int64_t sqrt(int64_t v) const {
+        int e = normalize4(v);
+        int64_t x = v + one / 4, y = v - one / 4, z = 0;
+        vectoring(x, y, z);
+        int64_t root = scale(x, inverse_gain);
+        return (e >= 0) ? (root << e) : (root >> -e);
+    }
+
+    // ln(v) for v > 0: ln m = 2 atanh((m - 1) / (m + 1)), plus e ln 2
+    int64_t log(int64_t v) const {
+        int e = normalize2(v);
+        int64_t x = v + one, y = v - one, z = 0;
+        vectoring(x, y, z);
+        return z + z + times(ln2, e);
+    }
+
+    // exp(v), with the power of two returned in e: v = q ln 2 + r, |r| <= ln 2 / 2
+    int64_t exp(int64_t v, int& e) const {
+        int64_t q = scale(v, inverse_ln2);
+        q = (q + one / 2) >> fraction_bits;
+        int64_t x = inverse_gain, y = inverse_gain, z = v - times(ln2, q);
+        rotation(x, y, z);
+        e = static_cast<int>(q);
+        return x;
+    }
+
+    // atanh(v) for |v| < 1; beyond the convergence range as (ln(1 + v) - ln(1 - v)) / 2
+    int64_t atanh(int64_t v) const {
+        if (v < 3 * one / 4 && v > -3 * one / 4) {
+            int64_t x = one, y = v, z = 0;
+            vectoring(x, y, z);
+            return z;
+        }
+        return (log(one + v) - log(one - v)) >> 1;
+    }
+
+private:
+    hyperbolic_cordic() {
+        double gain = 1.0;
+        for (int s = 1, repeat = 4; s <= static_cast<int>(fraction_bits); ++s) {
+            for (int k = 0; k < (s == repeat ? 2 : 1); ++k) {
+                shifts.push_back(s);
+                angles.push_back(fixed(std::atanh(std::ldexp(1.0, -s))));
+                gain *= std::sqrt(1.0 - std::ldexp(1.0, -2 * s));
+            }
+            if (s == repeat) repeat = 3 * repeat + 1;
+        }
+        inverse_gain = fixed(1.0 / gain);
+        ln2 = fixed(std::log(2.0));
+        inverse_ln2 = fixed(1.0 / std::log(2.0));
+    }
+
+    static int64_t fixed(double v) {
+        return static_cast<int64_t>(std::llround(std::ldexp(v, static_cast<int>(fraction_bits))));
+    }
+
+    std::vector<int> shifts;        // iteration schedule
+    std::vector<int64_t> angles;    // atanh(2^-shift) per iteration
+    int64_t inverse_gain;           // 1 / K
+    int64_t ln2;
+    int64_t inverse_ln2;
+};
+
+// Working places for fixpnt<nbits, rbits>: guard bits beyond the type, within 64-bit registers
+template <unsigned nbits, unsigned rbits>
+constexpr unsigned hyperbolic_cordic_fraction_bits() {
+    constexpr unsigned wanted = nbits + 16;
+    constexpr unsigned room = 60 - (nbits - rbits);
+    return wanted < room ? wanted : room;
+}
+
+template <unsigned nbits, unsigned rbits, bool arithmetic, typename bt>
+int64_t to_cordic_register(const sw::universal::fixpnt<nbits, rbits, arithmetic, bt>& x) {
+    constexpr unsigned F = hyperbolic_cordic_fraction_bits<nbits, rbits>();
+    static_assert(F >= rbits && nbits < 62, "fixpnt too wide for the 64-bit CORDIC registers");
+    int64_t raw = static_cast<int64_t>(encode(x));
+    if ((raw >> (nbits - 1)) & 1) raw -= int64_t(1) << nbits;
+    return raw << (F - rbits);
+}
+
+// Round a register, shifted by 2^e, to the nearest fixpnt; saturates outside the type's range
+template <typename T, unsigned nbits, unsigned rbits>
+T from_cordic_register(int64_t v, int e = 0) {
+    constexpr unsigned F = hyperbolic_cordic_fraction_bits<nbits, rbits>();
+    constexpr int64_t max_raw = (int64_t(1) << (nbits - 1)) - 1;
+    int shift = static_cast<int>(F - rbits) - e;
+    int64_t raw;
+    if (shift > 62) {
+        raw = 0;
+    } else if (shift > 0) {
+        raw = (v + (int64_t(1) << (shift - 1))) >> shift;
+    } else if (v != 0 && (-shift >= 62 || std::bit_width(static_cast<uint64_t>(v < 0 ? -v : v)) - shift > static_cast<int>(nbits) - 1)) {
+        raw = (v < 0) ? -max_raw - 1 : max_raw;
+    } else {
+        raw = v << -shift;
+    }
+    if (raw > max_raw) raw = max_raw;
+    if (raw < -max_raw - 1) raw = -max_raw - 1;
+    return decode<T>(static_cast<encoding_word_t<T>>(static_cast<uint64_t>(raw)));
+}
+
+template <unsigned nbits, unsigned rbits, bool arithmetic, typename bt>
+sw::universal::fixpnt<nbits, rbits, arithmetic, bt> hyperbolicCordicSqrt(const sw::universal::fixpnt<nbits, rbits, arithmetic, bt>& x) {
+    using T = sw::universal::fixpnt<nbits, rbits, arithmetic, bt>;
+    const auto& cordic = hyperbolic_cordic<hyperbolic_cordic_fraction_bits<nbits, rbits>()>::table();
+    int64_t v = to_cordic_register(x);
+    if (v < 0) {
+        throw std::domain_error("Negative input not allowed");
+    }
+    if (v == 0) {
+        return T(0);
+    }
+    return from_cordic_register<T, nbits, rbits>(cordic.sqrt(v));
+}
+
+template <unsigned nbits, unsigned rbits, bool arithmetic, typename bt>
+sw::universal::fixpnt<nbits, rbits, arithmetic, bt> hyperbolicCordicLog(const sw::universal::fixpnt<nbits, rbits, arithmetic, bt>& x) {
+    using T = sw::universal::fixpnt<nbits, rbits, arithmetic, bt>;
+    const auto& cordic = hyperbolic_cordic<hyperbolic_cordic_fraction_bits<nbits, rbits>()>::table();
+    int64_t v = to_cordic_register(x);
+    if (v <= 0) {
+        throw std::domain_error("Logarithm of a non-positive input");
+    }
+    return from_cordic_register<T, nbits, rbits>(cordic.log(v));
+}
+
+template <unsigned nbits, unsigned rbits, bool arithmetic, typename bt>
+sw::universal::fixpnt<nbits, rbits, arithmetic, bt> hyperbolicCordicExp(const sw::universal::fixpnt<nbits, rbits, arithmetic, bt>& x) {
+    using T = sw::universal::fixpnt<nbits, rbits, arithmetic, bt>;
+    const auto& cordic = hyperbolic_cordic<hyperbolic_cordic_fraction_bits<nbits, rbits>()>::table();
+    int e = 0;
+    int64_t mantissa = cordic.exp(to_cordic_register(x), e);
+    return from_cordic_register<T, nbits, rbits>(mantissa, e);
+}
+
+template <unsigned nbits, unsigned rbits, bool arithmetic, typename bt>
+sw::universal::fixpnt<nbits, rbits, arithmetic, bt> hyperbolicCordicAtanh(const sw::universal::fixpnt<nbits, rbits, arithmetic, bt>& x) {
+    using T = sw::universal::fixpnt<nbits, rbits, arithmetic, bt>;
+    constexpr unsigned F = hyperbolic_cordic_fraction_bits<nbits, rbits>();
+    const auto& cordic = hyperbolic_cordic<F>::table();
+    int64_t v = to_cordic_register(x);
+    if (v >= hyperbolic_cordic<F>::one || v <= -hyperbolic_cordic<F>::one) {
+        throw std::domain_error("atanh argument outside (-1, 1)");
+    }
+    return from_cordic_register<T, nbits, rbits>(cordic.atanh(v));
+}
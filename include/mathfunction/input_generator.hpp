@@ -0,0 +1,171 @@
+#pragma once
+// input_generator.hpp: index-addressable input sets for the sqrt sweeps
+//
+// A generator describes a finite sequence of inputs of one type; fill()
+// produces any slice [first, first + count) of it directly, so a sweep can
+// be cut into blocks, threads or shards in any way and still see the same
+// inputs in the same positions. Random generators draw element k from the
+// Philox block of counter k, the structured ones compute it from k.
+//
+//   log_uniform   2^u, u uniform in [log2 lo, log2 hi)
+//   uniform       uniform in [lo, hi)
+//   boundaries    the radius encodings on either side of every power of two
+//                 in [lo, hi], where the spacing of every type changes
+//   encodings     every encoding of the type, in encoding order
+//   midpoints     inputs whose root falls next to the midpoint of two
+//                 consecutive values of the type, the hardest cases to round
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <mathfunction/encoding.hpp>
+#include <mathfunction/philox.hpp>
+#include <mathfunction/ulp.hpp>
+
+struct input_options {
+    double lo = 1e-9;
+    double hi = 1e9;
+    uint64_t samples = uint64_t(1) << 18;   // length of the random and midpoint sequences
+    uint64_t seed = 0x5eed;
+    unsigned radius = 8;                    // encodings on each side of a boundary
+};
+
+template <typename T>
+class input_generator {
+public:
+    virtual ~input_generator() = default;
+    virtual const char* name() const = 0;
+    virtual uint64_t size() const = 0;
+    // out[i] = element first + i of the sequence, for i < count
+    virtual void fill(uint64_t first, T* out, size_t count) const = 0;
+
+    std::vector<T> generate(uint64_t first, size_t count) const {
+        std::vector<T> batch(count);
+        fill(first, batch.data(), count);
+        return batch;
+    }
+    std::vector<T> generate() const {
+        return generate(0, static_cast<size_t>(size()));
+    }
+};
+
+template <typename T>
+class log_uniform_inputs : public input_generator<T> {
+public:
+    explicit log_uniform_inputs(const input_options& options)
+        : rng(options.seed, 1), samples(options.samples), lo(std::log2(options.lo)), width(std::log2(options.hi) - std::log2(options.lo)) {}
+    const char* name() const override { return "log_uniform"; }
+    uint64_t size() const override { return samples; }
+    void fill(uint64_t first, T* out, size_t count) const override {
+        for (size_t i = 0; i < count; ++i) out[i] = T(std::exp2(lo + width * rng.uniform(first + i)));
+    }
+
+private:
+    philox4x32 rng;
+    uint64_t samples;
+    double lo, width;
+};
+
+template <typename T>
+class uniform_inputs : public input_generator<T> {
+public:
+    explicit uniform_inputs(const input_options& options)
+        : rng(options.seed, 2), samples(options.samples), lo(options.lo), width(options.hi - options.lo) {}
+    const char* name() const override { return "uniform"; }
+    uint64_t size() const override { return samples; }
+    void fill(uint64_t first, T* out, size_t count) const override {
+        for (size_t i = 0; i < count; ++i) out[i] = T(lo + width * rng.uniform(first + i));
+    }
+
+private:
+    philox4x32 rng;
+    uint64_t samples;
+    double lo, width;
+};
+
+template <typename T>
+class boundary_inputs : public input_generator<T> {
+public:
+    explicit boundary_inputs(const input_options& options)
+        : radius(options.radius),
+          min_exponent(static_cast<int>(std::ceil(std::log2(options.lo)))),
+          exponents(std::max(0, static_cast<int>(std::floor(std::log2(options.hi))) - min_exponent + 1)) {}
+    const char* name() const override { return "boundaries"; }
+    uint64_t size() const override { return uint64_t(exponents) * (2 * radius + 1); }
+    void fill(uint64_t first, T* out, size_t count) const override {
+        using word = encoding_word_t<T>;
+        for (size_t i = 0; i < count; ++i) {
+            uint64_t k = first + i;
+            int exponent = min_exponent + static_cast<int>(k / (2 * radius + 1));
+            int64_t offset = static_cast<int64_t>(k % (2 * radius + 1)) - static_cast<int64_t>(radius);
+            // positive values of every type are ordered like their encodings
+            out[i] = decode<T>(static_cast<word>(encode(T(std::ldexp(1.0, exponent))) + static_cast<word>(offset)));
+        }
+    }
+
+private:
+    uint64_t radius;
+    int min_exponent;
+    int exponents;
+};
+
+template <typename T>
+class encoding_inputs : public input_generator<T> {
+public:
+    encoding_inputs() {
+        if (encoding_bits<T>() > 32) throw std::runtime_error("encodings: too many encodings to enumerate");
+    }
+    const char* name() const override { return "encodings"; }
+    uint64_t size() const override {
+        if constexpr (encoding_bits<T>() > 32) return 0;
+        else return uint64_t(1) << encoding_bits<T>();
+    }
+    void fill(uint64_t first, T* out, size_t count) const override {
+        for (size_t i = 0; i < count; ++i) out[i] = decode<T>(static_cast<encoding_word_t<T>>(first + i));
+    }
+};
+
+// Inputs near m^2 for the midpoint m of a log-uniform y and the next value
+// of T above it, one encoding below, at and above the rounded square
+template <typename T>
+class midpoint_inputs : public input_generator<T> {
+public:
+    explicit midpoint_inputs(const input_options& options)
+        : rng(options.seed, 3), samples(options.samples), lo(0.5 * std::log2(options.lo)), width(0.5 * (std::log2(options.hi) - std::log2(options.lo))) {}
+    const char* name() const override { return "midpoints"; }
+    uint64_t size() const override { return samples; }
+    void fill(uint64_t first, T* out, size_t count) const override {
+        using word = encoding_word_t<T>;
+        for (size_t i = 0; i < count; ++i) {
+            uint64_t k = first + i;
+            T y(std::exp2(lo + width * rng.uniform(k / 3)));
+            long double m = (static_cast<long double>(y) + static_cast<long double>(next_up(y))) / 2;
+            T x(static_cast<double>(m * m));
+            out[i] = decode<T>(static_cast<word>(encode(x) + static_cast<word>(static_cast<int>(k % 3) - 1)));
+        }
+    }
+
+private:
+    philox4x32 rng;
+    uint64_t samples;
+    double lo, width;
+};
+
+inline const std::vector<std::string>& input_generator_names() {
+    static const std::vector<std::string> names = { "log_uniform", "uniform", "boundaries", "encodings", "midpoints" };
+    return names;
+}
+
+template <typename T>
+std::unique_ptr<input_generator<T>> make_input_generator(const std::string& name, const input_options& options = {}) {
+    if (name == "log_uniform") return std::make_unique<log_uniform_inputs<T>>(options);
+    if (name == "uniform") return std::make_unique<uniform_inputs<T>>(options);
+    if (name == "boundaries") return std::make_unique<boundary_inputs<T>>(options);
+    if (name == "encodings") return std::make_unique<encoding_inputs<T>>();
+    if (name == "midpoints") return std::make_unique<midpoint_inputs<T>>(options);
+    throw std::runtime_error("unknown input generator " + name);
+}
@@ -0,0 +1,70 @@
+#pragma once
+// latency_histogram.hpp: fixed-memory log-linear histogram of per-call latencies
+//
+// Same layout as an HDR histogram: values below 2^sub_bits are recorded
+// exactly, larger values land in buckets of 2^(sub_bits-1) linear steps per
+// power of two, so every recorded value is resolved to within 1/64 of itself.
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <vector>
+
+class latency_histogram {
+public:
+    static constexpr int sub_bits = 7;
+    static constexpr uint64_t sub_count = uint64_t(1) << sub_bits;
+    static constexpr uint64_t half_count = sub_count / 2;
+
+    latency_histogram() : counts(bucket_index(~uint64_t(0)) + 1, 0) {}
+
+    void record(uint64_t value) {
+        ++counts[bucket_index(value)];
+        ++total;
+        max_value = std::max(max_value, value);
+        min_value = std::min(min_value, value);
+    }
+
+    void merge(const latency_histogram& rhs) {
+        for (size_t i = 0; i < counts.size(); ++i) counts[i] += rhs.counts[i];
+        total += rhs.total;
+        max_value = std::max(max_value, rhs.max_value);
+        min_value = std::min(min_value, rhs.min_value);
+    }
+
+    uint64_t count() const { return total; }
+    uint64_t max() const { return total ? max_value : 0; }
+    uint64_t min() const { return total ? min_value : 0; }
+
+    // Smallest recorded value v such that the fraction q of all samples is <= v,
+    // reported as the top of its bucket
+    uint64_t percentile(double q) const {
+        if (total == 0) return 0;
+        uint64_t rank = static_cast<uint64_t>(q * static_cast<double>(total) + 0.5);
+        rank = std::clamp<uint64_t>(rank, 1, total);
+        uint64_t seen = 0;
+        for (size_t i = 0; i < counts.size(); ++i) {
+            seen += counts[i];
+            if (seen >= rank) return std::min(bucket_upper(i), max_value);
+        }
+        return max_value;
+    }
+
+private:
+    std::vector<uint64_t> counts;
+    uint64_t total = 0;
+    uint64_t max_value = 0;
+    uint64_t min_value = ~uint64_t(0);
+
+    static size_t bucket_index(uint64_t value) {
+        if (value < sub_count) return static_cast<size_t>(value);
+        int shift = std::bit_width(value) - sub_bits;
+        return static_cast<size_t>(shift * half_count + (value >> shift));
+    }
+
+    static uint64_t bucket_upper(size_t index) {
+        if (index < sub_count) return index;
+        uint64_t shift = (index - sub_count) / half_count + 1;
+        uint64_t sub = index - shift * half_count;
+        return ((sub + 1) << shift) - 1;
+    }
+};
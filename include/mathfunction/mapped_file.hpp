@@ -0,0 +1,87 @@
+#pragma once
+// mapped_file.hpp: RAII memory mappings of whole files
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+class mapped_file {
+public:
+    mapped_file() = default;
+    mapped_file(mapped_file&& rhs) noexcept : base(std::exchange(rhs.base, nullptr)), length(std::exchange(rhs.length, 0)) {}
+    mapped_file& operator=(mapped_file&& rhs) noexcept {
+        if (this != &rhs) {
+            unmap();
+            base = std::exchange(rhs.base, nullptr);
+            length = std::exchange(rhs.length, 0);
+        }
+        return *this;
+    }
+    mapped_file(const mapped_file&) = delete;
+    mapped_file& operator=(const mapped_file&) = delete;
+    ~mapped_file() { unmap(); }
+
+    // Read-only view of an existing file; throws when it cannot be opened
+    static mapped_file open_read(const std::string& path) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) throw std::runtime_error("cannot open " + path + ": " + std::strerror(errno));
+        mapped_file file;
+        struct stat info;
+        if (fstat(fd, &info) == 0 && info.st_size > 0) file.map(fd, static_cast<size_t>(info.st_size), PROT_READ, path);
+        ::close(fd);
+        return file;
+    }
+
+    // Writable view of a file created, or truncated, to size bytes
+    static mapped_file create(const std::string& path, size_t size) {
+        int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) throw std::runtime_error("cannot create " + path + ": " + std::strerror(errno));
+        mapped_file file;
+        if (ftruncate(fd, static_cast<off_t>(size)) < 0) {
+            ::close(fd);
+            throw std::runtime_error("cannot size " + path + ": " + std::strerror(errno));
+        }
+        if (size > 0) file.map(fd, size, PROT_READ | PROT_WRITE, path);
+        ::close(fd);
+        return file;
+    }
+
+    const void* data() const { return base; }
+    void* data() { return base; }
+    size_t size() const { return length; }
+
+    // madvise on the pages overlapping [offset, offset + bytes)
+    void advise(int advice, size_t offset = 0, size_t bytes = size_t(-1)) const {
+        if (base == nullptr || offset >= length) return;
+        const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        size_t first = offset / page * page;
+        size_t last = (bytes > length - offset) ? length : offset + bytes;
+        ::madvise(static_cast<char*>(base) + first, last - first, advice);
+    }
+
+private:
+    void map(int fd, size_t size, int protection, const std::string& path) {
+        void* p = mmap(nullptr, size, protection, MAP_SHARED, fd, 0);
+        if (p == MAP_FAILED) {
+            ::close(fd);
+            throw std::runtime_error("cannot map " + path + ": " + std::strerror(errno));
+        }
+        base = p;
+        length = size;
+    }
+    void unmap() {
+        if (base != nullptr) munmap(base, length);
+        base = nullptr;
+        length = 0;
+    }
+
+    void* base = nullptr;
+    size_t length = 0;
+};
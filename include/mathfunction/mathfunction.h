@@ -0,0 +1,67 @@
+/* mathfunction.h: C ABI of libmathfunction, batch square roots over raw encodings
+ *
+ * Every entry point takes n encodings of one number type and writes their
+ * square roots to out, which may alias in. Posit and fixpnt values are their
+ * bit patterns; float and double are their IEEE-754 binary32 and binary64
+ * patterns. Large batches are split over threads; the IEEE basic path uses
+ * the widest SIMD unit found when the library is loaded.
+ */
+#ifndef MATHFUNCTION_H
+#define MATHFUNCTION_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+#  if defined(MATHFUNCTION_BUILD_SHARED)
+#    define MF_API __declspec(dllexport)
+#  elif defined(MATHFUNCTION_SHARED)
+#    define MF_API __declspec(dllimport)
+#  else
+#    define MF_API
+#  endif
+#else
+#  define MF_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MF_ABI_VERSION 1
+
+/* Kernels; values are part of the ABI and never renumbered. The entry points
+   take them as int, so that any value a caller passes is well defined and
+   rejected with MF_EINVAL when it names no kernel. */
+typedef enum mf_algo {
+    MF_ALGO_BASIC = 0,        /* the library square root of the type */
+    MF_ALGO_HERON = 1,
+    MF_ALGO_BAKHSHALI = 2,
+    MF_ALGO_CORDIC = 3,
+    MF_ALGO_EXP = 4,
+    MF_ALGO_POLY = 5,
+    MF_ALGO_GOLDSCHMIDT = 6,
+    MF_ALGO_FAST = 7          /* per exponent bucket, the fastest kernel meeting the accuracy target */
+} mf_algo;
+
+/* Return values */
+#define MF_OK 0
+#define MF_EDOM 1             /* an input was negative or NaR; its result is unspecified */
+#define MF_EINVAL 2           /* unknown algorithm or null pointer */
+
+MF_API int mf_sqrt_posit16_u16(const uint16_t* in, uint16_t* out, size_t n, int algo);
+MF_API int mf_sqrt_posit32_u32(const uint32_t* in, uint32_t* out, size_t n, int algo);
+MF_API int mf_sqrt_fixpnt16_u16(const uint16_t* in, uint16_t* out, size_t n, int algo);
+MF_API int mf_sqrt_float_u32(const uint32_t* in, uint32_t* out, size_t n, int algo);
+MF_API int mf_sqrt_double_u64(const uint64_t* in, uint64_t* out, size_t n, int algo);
+
+MF_API int mf_abi_version(void);
+MF_API const char* mf_algo_name(int algo);
+/* SIMD level picked at load time: "avx512f", "avx2" or "scalar" */
+MF_API const char* mf_cpu_features(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MATHFUNCTION_H */
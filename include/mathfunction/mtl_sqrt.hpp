@@ -0,0 +1,28 @@
+#pragma once
+// mtl_sqrt.hpp: element-wise sqrt and 2-norm over MTL4 dense vectors
+//
+// Views of the dense vectors on the array kernels of sqrt_batch.hpp.
+#include <cstddef>
+#include <boost/numeric/mtl/mtl.hpp>
+#include <mathfunction/sqrt_batch.hpp>
+
+// Element-wise square root
+template <typename T, typename Parameters>
+mtl::vec::dense_vector<T, Parameters> parallel_sqrt(const mtl::vec::dense_vector<T, Parameters>& v) {
+    size_t n = size(v);
+    mtl::vec::dense_vector<T, Parameters> result(n);
+    if (n == 0) return result;
+    const T* in = &v[0];
+    T* out = &result[0];
+    for_each_block(n, cache_block_elements<T>(), [&](size_t first, size_t last, size_t) {
+        sqrt_batch(in + first, out + first, last - first);
+    });
+    return result;
+}
+
+// 2-norm: sum of squares in a wide accumulator, then one sqrt
+template <typename T, typename Parameters>
+T parallel_two_norm(const mtl::vec::dense_vector<T, Parameters>& v) {
+    size_t n = size(v);
+    return (n == 0) ? T(0) : parallel_two_norm(&v[0], n);
+}
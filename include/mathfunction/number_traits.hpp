@@ -0,0 +1,38 @@
+#pragma once
+// number_traits.hpp: classification of the number types used by the sqrt kernels
+#include <limits>
+#include <type_traits>
+#include <universal/number/posit/posit.hpp>
+#include <universal/number/fixpnt/fixpnt.hpp>
+
+template <typename T>
+struct is_posit_type : std::false_type {};
+template <unsigned nbits, unsigned es>
+struct is_posit_type<sw::universal::posit<nbits, es>> : std::true_type {
+    static constexpr unsigned total_bits = nbits;
+    static constexpr unsigned exponent_bits = es;
+};
+
+template <typename T>
+struct is_fixpnt_type : std::false_type {};
+template <unsigned nbits, unsigned rbits, bool arithmetic, typename bt>
+struct is_fixpnt_type<sw::universal::fixpnt<nbits, rbits, arithmetic, bt>> : std::true_type {
+    static constexpr int total_bits = static_cast<int>(nbits);
+    static constexpr int fraction_bits = static_cast<int>(rbits);
+};
+
+template <typename T>
+constexpr bool is_posit_v = is_posit_type<T>::value;
+template <typename T>
+constexpr bool is_fixpnt_v = is_fixpnt_type<T>::value;
+
+// Number of significant bits a kernel must deliver for T;
+// a fixpnt carries at most nbits - 1 of them, at the top of its range
+template <typename T>
+constexpr int precision_bits() {
+    if constexpr (is_fixpnt_v<T>) {
+        return is_fixpnt_type<T>::total_bits - 1;
+    } else {
+        return std::numeric_limits<T>::digits;
+    }
+}
@@ -0,0 +1,302 @@
+#pragma once
+// perf_counters.hpp: hardware performance counters around batches of kernel calls
+//
+// Cycles come from the time-stamp counter; instructions, branch misses and
+// cache misses from one Linux perf_event_open group, so the three are
+// enabled, disabled and read together. A batch of inputs is measured as a
+// whole, which keeps the cost of the counter reads out of the per-call
+// numbers. Totals accumulate per (algorithm, type) across batches and threads.
+// Without PMU access (perf_event_paranoid, containers) only cycles are counted,
+// and the other counters are reported as n/a.
+//
+// The drivers call profile_range per range and keep a profile_scope for the
+// run; both do nothing unless the build defines MATHFUNCTION_PROFILE.
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__)
+#include <x86intrin.h>
+#define MATHFUNCTION_HAS_RDTSC 1
+#endif
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#ifdef MATHFUNCTION_PROFILE
+constexpr bool kernel_profiling = true;
+#else
+constexpr bool kernel_profiling = false;
+#endif
+
+struct kernel_counters {
+    uint64_t calls = 0;
+    uint64_t pmu_calls = 0;       // calls inside an open perf_event group
+    uint64_t cycles = 0;
+    uint64_t instructions = 0;
+    uint64_t branch_misses = 0;
+    uint64_t cache_misses = 0;
+
+    kernel_counters& operator+=(const kernel_counters& rhs) {
+        calls += rhs.calls;
+        pmu_calls += rhs.pmu_calls;
+        cycles += rhs.cycles;
+        instructions += rhs.instructions;
+        branch_misses += rhs.branch_misses;
+        cache_misses += rhs.cache_misses;
+        return *this;
+    }
+    double per_call(uint64_t total) const {
+        return calls ? static_cast<double>(total) / calls : 0.0;
+    }
+    // per-call average of a perf_event counter, n/a when the group never opened
+    std::string pmu_per_call(uint64_t total) const {
+        if (pmu_calls == 0) return "n/a";
+        std::ostringstream text;
+        text << std::fixed << std::setprecision(1) << static_cast<double>(total) / pmu_calls;
+        return text.str();
+    }
+};
+
+// Keeps the compiler from dropping a kernel call whose result is not used
+template <typename T>
+inline void keep_result(const T& value) {
+#if defined(__GNUC__)
+    asm volatile("" : : "r"(&value) : "memory");
+#else
+    (void)value;
+#endif
+}
+
+// Time-stamp counter, or nanoseconds where there is none
+inline uint64_t read_cycles() {
+#ifdef MATHFUNCTION_HAS_RDTSC
+    return __rdtsc();
+#else
+    return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+}
+
+// read_cycles() ticks per nanosecond, measured once against the steady clock
+inline double cycles_per_ns() {
+    static const double ratio = [] {
+        auto start = std::chrono::steady_clock::now();
+        uint64_t begin = read_cycles();
+        while (std::chrono::steady_clock::now() - start < std::chrono::milliseconds(20)) {
+        }
+        uint64_t end = read_cycles();
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        return static_cast<double>(end - begin) / ns;
+    }();
+    return ratio;
+}
+
+// Best of five timings of f, in ns per call, each over at least 5ms
+template <typename F>
+double best_ns_per_call(F f, size_t calls_per_run) {
+    double best = 1e300;
+    for (int trial = 0; trial < 5; ++trial) {
+        size_t runs = 0;
+        auto start = std::chrono::steady_clock::now();
+        auto stop = start;
+        do {
+            f();
+            ++runs;
+            stop = std::chrono::steady_clock::now();
+        } while (stop - start < std::chrono::milliseconds(5));
+        best = std::min(best, std::chrono::duration<double, std::nano>(stop - start).count() / (double(runs) * calls_per_run));
+    }
+    return best;
+}
+
+// Instructions, branch misses and cache misses of the calling thread, as one group
+class perf_counter_group {
+public:
+    perf_counter_group() {
+#if defined(__linux__)
+        const uint64_t configs[] = { PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_BRANCH_MISSES, PERF_COUNT_HW_CACHE_MISSES };
+        for (uint64_t config : configs) {
+            perf_event_attr attr{};
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.size = sizeof(attr);
+            attr.config = config;
+            attr.disabled = (leader < 0) ? 1 : 0;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_GROUP;
+            int fd = static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, leader, 0));
+            if (fd < 0) {
+                close_all();
+                return;
+            }
+            if (leader < 0) leader = fd;
+            fds.push_back(fd);
+        }
+#endif
+    }
+    ~perf_counter_group() { close_all(); }
+    perf_counter_group(const perf_counter_group&) = delete;
+    perf_counter_group& operator=(const perf_counter_group&) = delete;
+
+    bool available() const { return leader >= 0; }
+
+    void start() {
+#if defined(__linux__)
+        if (available()) {
+            ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+            ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        }
+#endif
+    }
+
+    // Stop counting and add the group values to counters; false when nothing was counted
+    bool stop(kernel_counters& counters) {
+#if defined(__linux__)
+        if (available()) {
+            ioctl(leader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+            uint64_t values[1 + 3] = {};
+            if (read(leader, values, sizeof(values)) == static_cast<ssize_t>(sizeof(values)) && values[0] == 3) {
+                counters.instructions += values[1];
+                counters.branch_misses += values[2];
+                counters.cache_misses += values[3];
+                return true;
+            }
+        }
+#endif
+        return false;
+    }
+
+private:
+    int leader = -1;
+    std::vector<int> fds;
+
+    void close_all() {
+#if defined(__linux__)
+        for (int fd : fds) close(fd);
+#endif
+        fds.clear();
+        leader = -1;
+    }
+};
+
+// Totals per (algorithm, type) over the whole run
+class kernel_profile {
+public:
+    static kernel_profile& instance() {
+        static kernel_profile profile;
+        return profile;
+    }
+
+    void add(const std::string& algorithm, const std::string& type_name, const kernel_counters& counters) {
+        std::lock_guard<std::mutex> lock(mutex);
+        totals[{ algorithm, type_name }] += counters;
+    }
+
+    void report(std::ostream& out) const {
+        std::lock_guard<std::mutex> lock(mutex);
+        out << std::setw(12) << "Algorithm" << std::setw(10) << "Type" << std::setw(10) << "Calls"
+            << std::setw(16) << "Cycles" << std::setw(16) << "Instructions" << std::setw(14) << "Branch miss"
+            << std::setw(14) << "Cache miss" << "   (per call)" << std::endl;
+        for (const auto& [key, c] : totals) {
+            out << std::setw(12) << key.first << std::setw(10) << key.second << std::setw(10) << c.calls
+                << std::fixed << std::setprecision(1) << std::setw(16) << c.per_call(c.cycles) << std::defaultfloat
+                << std::setw(16) << c.pmu_per_call(c.instructions) << std::setw(14) << c.pmu_per_call(c.branch_misses)
+                << std::setw(14) << c.pmu_per_call(c.cache_misses) << std::endl;
+        }
+    }
+
+private:
+    mutable std::mutex mutex;
+    std::map<std::pair<std::string, std::string>, kernel_counters> totals;
+};
+
+// Run kernel over the values converted to T, repetitions times, inside one counter window.
+// Values that are not positive in T are skipped, as the drivers skip them on error.
+template <typename T, typename Kernel>
+kernel_counters profile_batch(const std::string& algorithm, const std::string& type_name,
+                              const std::vector<double>& values, Kernel kernel, int repetitions = 100) {
+    thread_local perf_counter_group group;
+
+    std::vector<T> inputs;
+    for (double value : values) {
+        T x(value);
+        if (x > T(0)) inputs.push_back(x);
+    }
+
+    kernel_counters counters;
+    group.start();
+    uint64_t begin = read_cycles();
+    try {
+        for (int r = 0; r < repetitions; ++r) {
+            for (size_t i = 0; i < inputs.size(); ++i) {
+                keep_result(kernel(inputs[i]));
+            }
+        }
+    } catch (const std::exception&) {
+        // a kernel that throws on this batch has no meaningful counts
+        kernel_counters discarded;
+        group.stop(discarded);
+        return counters;
+    }
+    uint64_t end = read_cycles();
+    bool counted = group.stop(counters);
+    counters.cycles = end - begin;
+    counters.calls = static_cast<uint64_t>(repetitions) * inputs.size();
+    counters.pmu_calls = counted ? counters.calls : 0;
+
+    kernel_profile::instance().add(algorithm, type_name, counters);
+    return counters;
+}
+
+// CSV rows with per-call averages, one column per type, next to the accuracy rows
+inline void append_counter_rows(std::vector<std::vector<std::string>>& csv_data, const std::vector<kernel_counters>& per_type) {
+    auto row = [&](const std::string& label, uint64_t kernel_counters::* field, bool pmu) {
+        std::vector<std::string> r{ label };
+        for (const auto& c : per_type) r.push_back(pmu ? c.pmu_per_call(c.*field) : std::to_string(c.per_call(c.*field)));
+        csv_data.push_back(r);
+    };
+    row("Cycles/call", &kernel_counters::cycles, false);
+    row("Instructions/call", &kernel_counters::instructions, true);
+    row("Branch misses/call", &kernel_counters::branch_misses, true);
+    row("Cache misses/call", &kernel_counters::cache_misses, true);
+}
+
+// Counter rows of kernel on each of Types over the values 2^i * scale, i < count,
+// appended to the CSV of one range of a driver; names label the types
+template <typename... Types, typename Kernel>
+void profile_range(const std::string& algorithm, const std::vector<std::string>& names, double scale, int count,
+                   Kernel kernel, std::vector<std::vector<std::string>>& csv_data) {
+    if constexpr (kernel_profiling) {
+        std::vector<double> values;
+        for (int i = 0; i < count; ++i) values.push_back(std::ldexp(scale, i));
+        size_t t = 0;
+        append_counter_rows(csv_data, { profile_batch<Types>(algorithm, names.at(t++), values, kernel)... });
+    }
+}
+
+// Prints the run totals when a profiling driver leaves main
+class profile_scope {
+public:
+    profile_scope() = default;
+    ~profile_scope() {
+        if constexpr (kernel_profiling) kernel_profile::instance().report(std::cout);
+    }
+    profile_scope(const profile_scope&) = delete;
+    profile_scope& operator=(const profile_scope&) = delete;
+};
@@ -0,0 +1,49 @@
+#pragma once
+// philox.hpp: Philox4x32-10 counter-based random numbers (Salmon et al., SC'11)
+//
+// Every output block is a pure function of (key, counter), so element k of
+// a random sequence is computed directly instead of by advancing a state:
+// threads and shards that split a sweep draw exactly the values one
+// sequential pass would.
+#include <array>
+#include <cstdint>
+
+class philox4x32 {
+public:
+    using counter_type = std::array<uint32_t, 4>;
+    using key_type = std::array<uint32_t, 2>;
+
+    explicit philox4x32(uint64_t seed, uint32_t stream = 0)
+        : key{ static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32) }, stream(stream) {}
+
+    // The ten-round block of an arbitrary counter
+    static counter_type block(counter_type counter, key_type key) {
+        for (int r = 0; r < 10; ++r) {
+            if (r > 0) {
+                key[0] += 0x9E3779B9u;
+                key[1] += 0xBB67AE85u;
+            }
+            uint64_t p0 = uint64_t(0xD2511F53u) * counter[0];
+            uint64_t p1 = uint64_t(0xCD9E8D57u) * counter[2];
+            counter = { static_cast<uint32_t>(p1 >> 32) ^ counter[1] ^ key[0], static_cast<uint32_t>(p1),
+                        static_cast<uint32_t>(p0 >> 32) ^ counter[3] ^ key[1], static_cast<uint32_t>(p0) };
+        }
+        return counter;
+    }
+
+    // 128 random bits for element index of this stream
+    counter_type operator()(uint64_t index) const {
+        return block({ static_cast<uint32_t>(index), static_cast<uint32_t>(index >> 32), stream, 0 }, key);
+    }
+
+    // Uniform double in [0, 1) with 53 random bits, for element index
+    double uniform(uint64_t index) const {
+        counter_type r = (*this)(index);
+        uint64_t bits = (uint64_t(r[0]) << 32 | r[1]) >> 11;
+        return static_cast<double>(bits) * 0x1.0p-53;
+    }
+
+private:
+    key_type key;
+    uint32_t stream;
+};
@@ -0,0 +1,52 @@
+#pragma once
+// poly_sqrt.hpp: square root through exponent halving and a minimax polynomial
+//
+// The input is reduced to x = m * 2^(2k) with m in [1,4), so that
+// sqrt(x) = sqrt(m) * 2^k. sqrt(m) comes from a relative-error minimax
+// polynomial evaluated in T, followed by Heron steps when T needs more
+// bits than the polynomial provides. No transcendental is called.
+#include <cmath>
+#include <stdexcept>
+#include <mathfunction/number_traits.hpp>
+#include <mathfunction/range_reduction.hpp>
+#include <mathfunction/remez_coefficients.hpp>
+
+// Coefficient table used for T: the generated polynomial of least total
+// cost for the precision of T. Every target that includes the kernels
+// depends on remez_coefficients, which generates the header.
+template <typename T>
+using poly_sqrt_coefficients = remez_sqrt<remez_sqrt_degree(precision_bits<T>())>;
+
+// Heron steps needed on top of the polynomial
+template <typename T>
+constexpr int poly_sqrt_refinements() {
+    return remez_refinements(poly_sqrt_coefficients<T>::bits, precision_bits<T>());
+}
+
+template <typename T>
+T polySqrt(T S) {
+    // Avoiding negative values
+    if (S < T(0)) {
+        throw std::runtime_error("Negative value encountered in polySqrt");
+    }
+    if (S == T(0)) {
+        return T(0);
+    }
+
+    int k;
+    T m = sqrt_reduce(S, k);
+
+    // Horner evaluation in the normalized variable t = (2m - (lo + hi)) / (hi - lo)
+    using table = poly_sqrt_coefficients<T>;
+    T t = m * T(2.0 / (table::hi - table::lo)) - T((table::lo + table::hi) / (table::hi - table::lo));
+    T y = T(table::c[table::degree]);
+    for (int i = table::degree - 1; i >= 0; --i) {
+        y = y * t + T(table::c[i]);
+    }
+
+    for (int i = 0; i < poly_sqrt_refinements<T>(); ++i) {
+        y = (y + m / y) * T(0.5);
+    }
+
+    return y * power_of_two<T>(k);
+}
@@ -0,0 +1,91 @@
+#pragma once
+// range_reduction.hpp: exponent and mantissa of a value, per number type
+//
+// The root functions all work on a mantissa in a short interval and put
+// the exponent back afterwards: x = m * 2^(n*k) with m in [1, 2^n) gives
+// x^(1/n) = m^(1/n) * 2^k. The exponent comes from the encoding where the
+// type has one (posit scale, ilogb, the leading bit of a fixpnt), and the
+// scaling by 2^e never overflows on the way: ldexp for IEEE types, a
+// rounding and saturating shift of the encoding for fixpnt, and steps that
+// stay inside the dynamic range for posits.
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <mathfunction/number_traits.hpp>
+#include <mathfunction/encoding.hpp>
+
+// Two's complement integer behind a fixpnt, sign-extended
+template <typename T>
+int64_t fixpnt_raw(const T& x) {
+    constexpr int nbits = is_fixpnt_type<T>::total_bits;
+    int64_t raw = static_cast<int64_t>(encode(x));
+    if (nbits < 64 && ((raw >> (nbits - 1)) & 1)) raw -= int64_t(1) << nbits;
+    return raw;
+}
+
+// Binary exponent e of x > 0, with 2^e <= x < 2^(e+1)
+template <typename T>
+int binary_exponent(const T& x) {
+    if constexpr (is_posit_v<T>) {
+        return sw::universal::scale(x);
+    } else if constexpr (is_fixpnt_v<T>) {
+        // the leading bit of the encoding; no multiplication by T(2), which wraps in formats with a single integer bit
+        int64_t raw = fixpnt_raw(x);
+        return std::bit_width(static_cast<uint64_t>(raw < 0 ? -raw : raw)) - 1 - is_fixpnt_type<T>::fraction_bits;
+    } else {
+        return std::ilogb(x);
+    }
+}
+
+// Power of two 2^e in T
+template <typename T>
+T power_of_two(int e) {
+    return T(std::ldexp(1.0, e));
+}
+
+// x * 2^e without intermediate overflow; a fixpnt saturates at the ends of its range
+// and rounds to nearest when bits shift out
+template <typename T>
+T scale_by_power_of_two(const T& x, int e) {
+    if constexpr (std::is_floating_point_v<T>) {
+        return std::ldexp(x, e);
+    } else if constexpr (is_fixpnt_v<T>) {
+        constexpr int nbits = is_fixpnt_type<T>::total_bits;
+        constexpr int64_t max_raw = (int64_t(1) << (nbits - 1)) - 1;
+        int64_t raw = fixpnt_raw(x);
+        if (e < 0) {
+            raw = (-e >= 63) ? 0 : (raw + (int64_t(1) << (-e - 1))) >> -e;
+        } else if (raw != 0) {
+            int64_t magnitude = raw < 0 ? -raw : raw;
+            if (e >= nbits || std::bit_width(static_cast<uint64_t>(magnitude)) + e > nbits - 1) {
+                raw = raw < 0 ? -max_raw - 1 : max_raw;
+            } else {
+                raw = raw * (int64_t(1) << e);
+            }
+        }
+        return decode<T>(static_cast<encoding_word_t<T>>(static_cast<uint64_t>(raw)));
+    } else {
+        // steps of half the posit's dynamic range: the regime of such a power of two
+        // leaves room for all of its exponent bits, so every step is exact
+        constexpr int step = std::max(1, static_cast<int>(((is_posit_type<T>::total_bits - 2) << is_posit_type<T>::exponent_bits) / 2));
+        T result = x;
+        while (e > step) { result = result * power_of_two<T>(step); e -= step; }
+        while (e < -step) { result = result * power_of_two<T>(-step); e += step; }
+        return result * power_of_two<T>(e);
+    }
+}
+
+// Split x > 0 into m * 2^(n*k) with m in [1, 2^n); returns m and stores k
+template <int n, typename T>
+T root_reduce(const T& x, int& k) {
+    int e = binary_exponent(x);
+    k = (e >= 0) ? e / n : -((n - 1 - e) / n);
+    return scale_by_power_of_two(x, -n * k);
+}
+
+// Split x into m * 2^(2k) with m in [1,4); returns m and stores k
+template <typename T>
+T sqrt_reduce(const T& x, int& k) {
+    return root_reduce<2>(x, k);
+}
@@ -0,0 +1,125 @@
+#pragma once
+// reduction.hpp: parallel reductions whose result does not depend on the thread count
+//
+// The input is cut into fixed-size blocks; each block is folded
+// sequentially into its own partial, whichever thread runs it, and the
+// partials are combined pairwise in a tree whose shape depends only on the
+// number of blocks. Every floating-point operation therefore happens in the
+// same order on one thread or on sixty-four, and the result is bit-identical
+// across runs and machines with the same arithmetic. Threads take the blocks
+// in order and fold a partial into its parent as soon as its sibling is
+// done, so only a few partials per thread and tree level are alive at once,
+// however long the input.
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <mathfunction/sqrt_batch.hpp>
+
+// Destructive interference size of the x86-64 and most AArch64 cores
+constexpr size_t cache_line_size = 64;
+
+// One value per cache line, so neighbouring slots written by different threads do not share a line
+template <typename T>
+struct alignas(cache_line_size) padded {
+    T value;
+};
+
+// Neumaier's compensated sum: the low-order bits lost by every addition are
+// kept in a second accumulator, so the error does not grow with the number of terms
+struct neumaier_sum {
+    double sum = 0.0;
+    double compensation = 0.0;
+
+    void add(double x) {
+        double t = sum + x;
+        if (std::abs(sum) >= std::abs(x)) {
+            compensation += (sum - t) + x;
+        } else {
+            compensation += (x - t) + sum;
+        }
+        sum = t;
+    }
+
+    void merge(const neumaier_sum& rhs) {
+        add(rhs.sum);
+        compensation += rhs.compensation;
+    }
+
+    double value() const { return sum + compensation; }
+};
+
+// Fold every block of [0, n) with block(first, last, partial), starting each
+// partial from identity, and combine the partials with combine(lhs, rhs),
+// which must leave the result in lhs. threads = 0 uses the default of for_each_block.
+template <typename Partial, typename BlockFunction, typename Combine>
+Partial parallel_reduce(size_t n, size_t block_size, const Partial& identity, BlockFunction block, Combine combine, unsigned threads = 0) {
+    const size_t blocks = (n + block_size - 1) / block_size;
+    if (blocks == 0) return identity;
+
+    // fixed tree: node (level, index) combines nodes (level - 1, 2 index) and
+    // (level - 1, 2 index + 1), or passes the left one up when the right one is empty
+    unsigned top = 0;
+    while ((size_t(1) << top) < blocks) ++top;
+    std::mutex mutex;
+    std::map<std::pair<unsigned, size_t>, Partial> waiting;   // nodes whose sibling is not done yet
+    std::optional<Partial> root;
+    auto fold = [&](size_t index, Partial partial) {
+        for (unsigned level = 0; level < top; ++level, index /= 2) {
+            const size_t sibling = index ^ 1;
+            if ((sibling << level) >= blocks) continue;
+            std::unique_lock<std::mutex> lock(mutex);
+            auto it = waiting.find({ level, sibling });
+            if (it == waiting.end()) {
+                waiting.emplace(std::make_pair(level, index), std::move(partial));
+                return;
+            }
+            Partial other = std::move(it->second);
+            waiting.erase(it);
+            lock.unlock();
+            // the left node absorbs the right one
+            if (index % 2 == 0) {
+                combine(partial, other);
+            } else {
+                combine(other, partial);
+                partial = std::move(other);
+            }
+        }
+        root = std::move(partial);
+    };
+
+    std::atomic<size_t> next{ 0 };
+    auto worker = [&]() {
+        for (size_t b = next++; b < blocks; b = next++) {
+            Partial partial = identity;
+            block(b * block_size, std::min(n, (b + 1) * block_size), partial);
+            fold(b, std::move(partial));
+        }
+    };
+    const size_t workers = block_worker_count(n, block_size, threads);
+    if (workers <= 1) {
+        worker();
+    } else {
+        std::vector<std::thread> pool;
+        for (size_t w = 0; w < workers; ++w) pool.emplace_back(worker);
+        for (auto& th : pool) th.join();
+    }
+    return std::move(*root);
+}
+
+// Sum of term(i) over [0, n), compensated, independent of the thread count
+template <typename Term>
+double parallel_sum(size_t n, Term term, size_t block_size = 4096, unsigned threads = 0) {
+    return parallel_reduce(n, block_size, neumaier_sum{},
+        [&](size_t first, size_t last, neumaier_sum& partial) {
+            for (size_t i = first; i < last; ++i) partial.add(term(i));
+        },
+        [](neumaier_sum& lhs, const neumaier_sum& rhs) { lhs.merge(rhs); },
+        threads).value();
+}
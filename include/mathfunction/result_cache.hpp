@@ -0,0 +1,220 @@
+#pragma once
+// result_cache.hpp: persistent kernel results keyed by (kernel, kernel version, type, input encoding)
+//
+// Every (kernel, version, type) has one segment file of fixed-size entries
+// sorted by input encoding, so a lookup is a binary search in the mapped
+// file. index.csv lists the segments; segments of a kernel version other
+// than the one this build was configured with are deleted when the cache
+// opens. New results are merged into a fresh segment on flush() and renamed
+// over the old one, so a reader never maps a half-written file. Without the
+// configure-time kernel versions every lookup misses and nothing is stored.
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <mathfunction/encoding.hpp>
+#include <mathfunction/mapped_file.hpp>
+
+#if __has_include(<mathfunction/kernel_versions.hpp>)
+#include <mathfunction/kernel_versions.hpp>
+#define MATHFUNCTION_HAS_KERNEL_VERSIONS 1
+#endif
+
+// Version digest of a kernel, empty when unknown
+inline std::string kernel_version(const std::string& kernel) {
+#ifdef MATHFUNCTION_HAS_KERNEL_VERSIONS
+    for (const auto& entry : kernel_versions) {
+        if (kernel == entry.kernel) return entry.version;
+    }
+#endif
+    return "";
+}
+
+struct cache_entry {
+    uint64_t input;
+    uint64_t output;
+    uint32_t failed;      // the kernel threw for this input
+    uint32_t reserved;
+};
+
+constexpr uint64_t cache_segment_magic = 0x3147455351534d46ull;
+
+struct cache_segment_header {
+    uint64_t magic;
+    uint64_t entries;
+};
+
+// Read-only mapping of one segment file, empty when missing or malformed
+class mapped_segment {
+public:
+    explicit mapped_segment(const std::string& path) {
+        try {
+            file = mapped_file::open_read(path);
+        } catch (const std::runtime_error&) {
+            return;
+        }
+        const auto* header = static_cast<const cache_segment_header*>(file.data());
+        // the count is checked before it is multiplied, so a corrupt one cannot wrap around
+        if (file.size() < sizeof(cache_segment_header) || header->magic != cache_segment_magic
+            || header->entries > (file.size() - sizeof(cache_segment_header)) / sizeof(cache_entry)) {
+            file = mapped_file();
+        }
+    }
+
+    const cache_entry* begin() const {
+        return file.data() ? reinterpret_cast<const cache_entry*>(static_cast<const char*>(file.data()) + sizeof(cache_segment_header)) : nullptr;
+    }
+    const cache_entry* end() const {
+        return file.data() ? begin() + static_cast<const cache_segment_header*>(file.data())->entries : nullptr;
+    }
+    const cache_entry* find(uint64_t input) const {
+        const cache_entry* last = end();
+        const cache_entry* e = std::lower_bound(begin(), last, input, [](const cache_entry& a, uint64_t key) { return a.input < key; });
+        return (e != last && e->input == input) ? e : nullptr;
+    }
+
+private:
+    mapped_file file;
+};
+
+class result_cache {
+public:
+    explicit result_cache(std::string directory) : directory(std::move(directory)) {
+        std::filesystem::create_directories(this->directory);
+        std::ifstream index(index_path());
+        std::string line;
+        while (std::getline(index, line)) {
+            std::stringstream ss(line);
+            segment_info info;
+            if (!std::getline(ss, info.kernel, ',') || !std::getline(ss, info.version, ',') || !std::getline(ss, info.type, ',') || !std::getline(ss, info.file, ',')) continue;
+            if (info.version != kernel_version(info.kernel)) {
+                std::filesystem::remove(this->directory + "/" + info.file);
+                continue;
+            }
+            segments[info.kernel + "," + info.type] = info;
+        }
+        write_index();
+    }
+    ~result_cache() {
+        try { flush(); } catch (...) {}
+    }
+
+    bool enabled() const {
+        return !kernel_version("basic").empty();
+    }
+
+    // outputs[i] = kernel(inputs[i]) from the cache or computed; failed[i] is set
+    // where the kernel threw, and outputs[i] is then zero
+    template <typename T, typename Kernel>
+    void evaluate(const Kernel& kernel, const char* type_name, const std::vector<T>& inputs, std::vector<T>& outputs, std::vector<bool>& failed) {
+        outputs.assign(inputs.size(), T(0));
+        failed.assign(inputs.size(), false);
+        std::string version = kernel_version(kernel.name);
+        const mapped_segment* segment = version.empty() ? nullptr : open_segment(kernel.name, version, type_name);
+
+        std::vector<cache_entry> computed;
+        uint64_t segment_hits = 0;
+        for (size_t i = 0; i < inputs.size(); ++i) {
+            uint64_t input = encode(inputs[i]);
+            if (const cache_entry* e = segment ? segment->find(input) : nullptr) {
+                outputs[i] = decode<T>(static_cast<encoding_word_t<T>>(e->output));
+                failed[i] = e->failed != 0;
+                ++segment_hits;
+                continue;
+            }
+            try {
+                outputs[i] = kernel(inputs[i]);
+            } catch (const std::exception&) {
+                failed[i] = true;
+            }
+            computed.push_back({ input, static_cast<uint64_t>(encode(outputs[i])), failed[i] ? 1u : 0u, 0u });
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        hit_count += segment_hits;
+        miss_count += computed.size();
+        if (!version.empty() && !computed.empty()) {
+            auto& target = pending[std::string(kernel.name) + "," + type_name];
+            target.insert(target.end(), computed.begin(), computed.end());
+        }
+    }
+
+    // Merge the new results into their segments and rewrite the index;
+    // not to be called while another thread is in evaluate()
+    void flush() {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (auto& [key, added] : pending) {
+            segment_info& info = segments[key];
+            if (info.file.empty()) {
+                info.kernel = key.substr(0, key.find(','));
+                info.type = key.substr(key.find(',') + 1);
+                info.file = info.kernel + "-" + info.type + ".seg";
+            }
+            info.version = kernel_version(info.kernel);
+
+            std::vector<cache_entry> entries;
+            if (auto it = mapped.find(key); it != mapped.end()) entries.assign(it->second->begin(), it->second->end());
+            entries.insert(entries.end(), added.begin(), added.end());
+            std::stable_sort(entries.begin(), entries.end(), [](const cache_entry& a, const cache_entry& b) { return a.input < b.input; });
+            entries.erase(std::unique(entries.begin(), entries.end(), [](const cache_entry& a, const cache_entry& b) { return a.input == b.input; }), entries.end());
+
+            std::string path = directory + "/" + info.file;
+            std::ofstream out(path + ".tmp", std::ios::binary);
+            cache_segment_header header{ cache_segment_magic, entries.size() };
+            out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            out.write(reinterpret_cast<const char*>(entries.data()), static_cast<std::streamsize>(entries.size() * sizeof(cache_entry)));
+            out.close();
+            if (!out) throw std::runtime_error("result_cache: cannot write " + path);
+            std::filesystem::rename(path + ".tmp", path);
+            mapped.erase(key);
+        }
+        pending.clear();
+        write_index();
+    }
+
+    uint64_t hits() const { return hit_count; }
+    uint64_t misses() const { return miss_count; }
+
+private:
+    struct segment_info {
+        std::string kernel, version, type, file;
+    };
+
+    std::string index_path() const { return directory + "/index.csv"; }
+
+    void write_index() const {
+        std::ofstream index(index_path() + ".tmp");
+        for (const auto& [key, info] : segments) {
+            index << info.kernel << "," << info.version << "," << info.type << "," << info.file << "\n";
+        }
+        index.close();
+        std::filesystem::rename(index_path() + ".tmp", index_path());
+    }
+
+    const mapped_segment* open_segment(const std::string& kernel, const std::string& version, const std::string& type) {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::string key = kernel + "," + type;
+        auto info = segments.find(key);
+        if (info == segments.end() || info->second.version != version) return nullptr;
+        auto& segment = mapped[key];
+        if (!segment) segment = std::make_unique<mapped_segment>(directory + "/" + info->second.file);
+        return segment.get();
+    }
+
+    std::string directory;
+    std::mutex mutex;
+    std::map<std::string, segment_info> segments;
+    std::map<std::string, std::unique_ptr<mapped_segment>> mapped;
+    std::map<std::string, std::vector<cache_entry>> pending;
+    uint64_t hit_count = 0;
+    uint64_t miss_count = 0;
+};
@@ -0,0 +1,163 @@
+#pragma once
+// result_diff.hpp: per-input comparison of two result sets of one number type
+//
+// Results are compared on their encodings, and two results differ by the
+// number of representable values between them: posit and fixpnt encodings
+// order like two's complement integers and IEEE encodings like
+// sign-magnitude ones, so that distance is the difference of two integer
+// ordinals. Result sets are cut into blocks that are compared in parallel
+// and merged in a fixed order (reduction.hpp), so the first differences
+// reported are the same on any thread count. A block is first scanned with
+// a branch-free count that the compiler vectorizes; only a block with a
+// difference is walked element by element.
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include <mathfunction/encoding.hpp>
+#include <mathfunction/error_stats.hpp>
+#include <mathfunction/reduction.hpp>
+#include <mathfunction/result_cache.hpp>
+
+// Elements per block: large enough that the per-block histograms stay small next to the data
+constexpr size_t diff_block_elements = size_t(1) << 20;
+
+// Distance of a result whose kernel threw on one side only
+constexpr uint64_t diff_failed_ulps = std::numeric_limits<uint64_t>::max();
+
+// Position of an encoding in the order of the values of T
+template <typename T>
+int64_t encoding_ordinal(encoding_word_t<T> bits) {
+    constexpr unsigned nbits = encoding_bits<T>();
+    const uint64_t word = static_cast<uint64_t>(bits);
+    const uint64_t sign = uint64_t(1) << (nbits - 1);
+    if constexpr (std::is_floating_point_v<T>) {
+        // -0 and +0 share ordinal 0
+        const int64_t magnitude = static_cast<int64_t>(word & ~sign);
+        return (word & sign) ? -magnitude : magnitude;
+    } else {
+        return (nbits < 64 && (word & sign)) ? static_cast<int64_t>(word) - (int64_t(1) << (nbits - 1) << 1) : static_cast<int64_t>(word);
+    }
+}
+
+// Number of steps of T between two results
+template <typename T>
+uint64_t encoding_distance(encoding_word_t<T> lhs, encoding_word_t<T> rhs) {
+    int64_t a = encoding_ordinal<T>(lhs), b = encoding_ordinal<T>(rhs);
+    // unsigned wrap-around gives the exact distance, which can exceed the range of int64_t for double
+    return (a >= b) ? static_cast<uint64_t>(a) - static_cast<uint64_t>(b) : static_cast<uint64_t>(b) - static_cast<uint64_t>(a);
+}
+
+struct result_difference {
+    uint64_t position;    // index in the left result set
+    uint64_t input;       // input encoding, or the position when the sets carry no inputs
+    uint64_t lhs;         // result encodings
+    uint64_t rhs;
+    uint64_t ulps;        // diff_failed_ulps when the kernel threw on one side only
+};
+
+struct result_diff {
+    uint64_t compared = 0;    // inputs present in both sets
+    uint64_t changed = 0;
+    uint64_t only_lhs = 0;    // inputs of one set missing from the other
+    uint64_t only_rhs = 0;
+    uint64_t max_ulps = 0;
+    result_difference largest{};              // first difference of max_ulps
+    ulp_histogram histogram;                  // ulps of the changed results
+    std::vector<result_difference> first;     // in position order, at most limit
+    size_t limit = 0;
+
+    void add(const result_difference& d) {
+        ++changed;
+        histogram.record(d.ulps == diff_failed_ulps ? std::numeric_limits<double>::infinity() : static_cast<double>(d.ulps));
+        if (changed == 1 || d.ulps > max_ulps) {
+            max_ulps = d.ulps;
+            largest = d;
+        }
+        if (first.size() < limit) first.push_back(d);
+    }
+
+    // rhs covers later positions than this
+    void merge(const result_diff& rhs) {
+        compared += rhs.compared;
+        only_lhs += rhs.only_lhs;
+        only_rhs += rhs.only_rhs;
+        if (rhs.changed > 0 && (changed == 0 || rhs.max_ulps > max_ulps)) {
+            max_ulps = rhs.max_ulps;
+            largest = rhs.largest;
+        }
+        changed += rhs.changed;
+        histogram.merge(rhs.histogram);
+        for (size_t i = 0; i < rhs.first.size() && first.size() < limit; ++i) first.push_back(rhs.first[i]);
+    }
+};
+
+// Compare lhs[i] with rhs[i] for every i in [0, n); the position doubles as the input
+template <typename T>
+result_diff diff_results(const encoding_word_t<T>* lhs, const encoding_word_t<T>* rhs, size_t n, size_t limit, unsigned threads = 0) {
+    result_diff identity;
+    identity.limit = limit;
+    return parallel_reduce(n, diff_block_elements, identity,
+        [&](size_t first, size_t last, result_diff& partial) {
+            partial.compared += last - first;
+            size_t mismatches = 0;
+            for (size_t i = first; i < last; ++i) mismatches += (lhs[i] != rhs[i]);
+            if (mismatches == 0) return;
+            for (size_t i = first; i < last; ++i) {
+                if (lhs[i] != rhs[i]) partial.add({ i, i, lhs[i], rhs[i], encoding_distance<T>(lhs[i], rhs[i]) });
+            }
+        },
+        [](result_diff& lhs, const result_diff& rhs) { lhs.merge(rhs); },
+        threads);
+}
+
+// Compare two sets of cache entries sorted by input, joined on the input encoding.
+// Block b of lhs takes the rhs entries from the input of its first entry up to
+// that of the next block, the first and last blocks also those beyond either end
+template <typename T>
+result_diff diff_results(const cache_entry* lhs, size_t nl, const cache_entry* rhs, size_t nr, size_t limit, unsigned threads = 0) {
+    auto by_input = [](const cache_entry& e, uint64_t key) { return e.input < key; };
+    auto rhs_bound = [&](size_t position) {
+        if (position == 0) return rhs;
+        if (position >= nl) return rhs + nr;
+        return std::lower_bound(rhs, rhs + nr, lhs[position].input, by_input);
+    };
+    result_diff identity;
+    identity.limit = limit;
+    if (nl == 0) {
+        identity.only_rhs = nr;
+        return identity;
+    }
+    return parallel_reduce(nl, diff_block_elements, identity,
+        [&](size_t first, size_t last, result_diff& partial) {
+            const cache_entry* r = rhs_bound(first);
+            const cache_entry* r_end = rhs_bound(last);
+            size_t i = first;
+            while (i < last && r != r_end) {
+                if (lhs[i].input < r->input) {
+                    ++partial.only_lhs;
+                    ++i;
+                } else if (r->input < lhs[i].input) {
+                    ++partial.only_rhs;
+                    ++r;
+                } else {
+                    ++partial.compared;
+                    if (lhs[i].failed != r->failed) {
+                        partial.add({ i, lhs[i].input, lhs[i].output, r->output, diff_failed_ulps });
+                    } else if (lhs[i].output != r->output) {
+                        using word = encoding_word_t<T>;
+                        partial.add({ i, lhs[i].input, lhs[i].output, r->output,
+                                      encoding_distance<T>(static_cast<word>(lhs[i].output), static_cast<word>(r->output)) });
+                    }
+                    ++i;
+                    ++r;
+                }
+            }
+            partial.only_lhs += last - i;
+            partial.only_rhs += static_cast<uint64_t>(r_end - r);
+        },
+        [](result_diff& lhs, const result_diff& rhs) { lhs.merge(rhs); },
+        threads);
+}
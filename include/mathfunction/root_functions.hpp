@@ -0,0 +1,168 @@
+#pragma once
+// root_functions.hpp: rsqrt, cube root and overflow-safe hypot on the shared range reduction
+//
+// Each function reduces its argument once with root_reduce, runs a short
+// iteration on a mantissa of known range, and scales the result back by a
+// power of two:
+//     rsqrt:  m in [1,4),  Newton y = y (3 - m y^2) / 2 from the Goldschmidt seed
+//     cbrt:   m in [1,8),  Newton y = y + (m / y^2 - y) / 3 from a cubic seed
+//     hypot:  both arguments scaled by the same power of two, so that the
+//             sum of squares stays inside the range of T
+// Each Newton step doubles the correct bits, so the step count follows
+// from the precision of T as in the Goldschmidt kernel. A fixpnt carries
+// the mantissa with only its own fraction bits, so its rsqrt and cbrt are
+// good to a few ulps rather than to the last bit.
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+#include <mathfunction/range_reduction.hpp>
+#include <mathfunction/goldschmidt.hpp>
+
+// Minimax seed for cbrt(m) on [1,8) in t = (2m - 9) / 7, good to 6.2 bits
+constexpr double cube_root_seed[] = {
+    1.655776613151548, 0.4251530968037988, -0.14767211572086192, 0.06977886261816918
+};
+constexpr double cube_root_seed_bits = 6.2;
+
+template <typename T>
+constexpr int cube_root_iterations() {
+    double bits = cube_root_seed_bits;
+    int steps = 0;
+    while (bits < precision_bits<T>()) {
+        bits = 2.0 * bits - 1.0;
+        ++steps;
+    }
+    return steps;
+}
+
+// 1/sqrt(m) for m in [1,4)
+template <typename T>
+T rsqrt_mantissa(const T& m) {
+    T y = goldschmidt_seed_rsqrt(m);
+    for (int i = 0; i < goldschmidt_iterations<T>(); ++i) {
+        y = y * (T(1.5) - T(0.5) * m * y * y);
+    }
+    return y;
+}
+
+template <typename T>
+T rsqrt(T x) {
+    if (!(x > T(0))) {
+        throw std::domain_error("rsqrt of a non-positive input");
+    }
+    int k;
+    T m = sqrt_reduce(x, k);
+    return scale_by_power_of_two(rsqrt_mantissa(m), -k);
+}
+
+// cbrt(m) for m in [1,8)
+template <typename T>
+T cube_root_mantissa(const T& m) {
+    T t = m * T(2.0 / 7.0) - T(9.0 / 7.0);
+    T y = ((T(cube_root_seed[3]) * t + T(cube_root_seed[2])) * t + T(cube_root_seed[1])) * t + T(cube_root_seed[0]);
+    for (int i = 0; i < cube_root_iterations<T>(); ++i) {
+        // as a correction, so that the rounding of 1/3 in narrow types scales only the small difference
+        y = y + (m / (y * y) - y) * T(1.0 / 3.0);
+    }
+    return y;
+}
+
+template <typename T>
+T cube_root(T x) {
+    if (x == T(0)) {
+        return T(0);
+    }
+    if (x < T(0)) {
+        T magnitude = T(0) - x;
+        if (magnitude < T(0)) {
+            // the most negative fixpnt has no positive counterpart: cbrt(x) = 2 cbrt(x / 8)
+            return scale_by_power_of_two(cube_root(scale_by_power_of_two(x, -3)), 1);
+        }
+        return T(0) - cube_root(magnitude);
+    }
+    int k;
+    T m = root_reduce<3>(x, k);
+    return scale_by_power_of_two(cube_root_mantissa(m), k);
+}
+
+// Rounded square root of a 64-bit integer
+inline uint64_t rounded_isqrt(uint64_t v) {
+    uint64_t r = static_cast<uint64_t>(std::sqrt(static_cast<double>(v)));
+    while (r * r > v) --r;
+    while ((r + 1) * (r + 1) <= v) ++r;
+    return (v - r * r > r) ? r + 1 : r;
+}
+
+// sqrt(x^2 + y^2) without overflow or underflow in the squares; a result
+// beyond the range of a fixpnt saturates.
+// IEEE and posit arguments are scaled by the same power of two so that the
+// larger lands in [1,2). A fixpnt is scaled on its encoding instead: the
+// squares of the two's complement integers are summed exactly, shifted
+// right first when they would not fit in 64 bits, and the integer square
+// root is rounded to nearest.
+template <typename T>
+T safe_hypot(T x, T y) {
+    if constexpr (is_fixpnt_v<T>) {
+        constexpr int nbits = is_fixpnt_type<T>::total_bits;
+        constexpr int64_t max_raw = (int64_t(1) << (nbits - 1)) - 1;
+        int64_t a = fixpnt_raw(x), b = fixpnt_raw(y);
+        uint64_t ma = static_cast<uint64_t>(a < 0 ? -a : a), mb = static_cast<uint64_t>(b < 0 ? -b : b);
+        int shift = std::max(0, static_cast<int>(std::bit_width(std::max(ma, mb))) - 31);
+        if (shift > 0) {
+            ma = (ma + (uint64_t(1) << (shift - 1))) >> shift;
+            mb = (mb + (uint64_t(1) << (shift - 1))) >> shift;
+        }
+        uint64_t root = rounded_isqrt(ma * ma + mb * mb);
+        int64_t raw = (root >> (nbits - 1 - shift)) != 0 ? max_raw : static_cast<int64_t>(root << shift);
+        return decode<T>(static_cast<encoding_word_t<T>>(std::min(raw, max_raw)));
+    } else {
+        if (x == T(0) && y == T(0)) {
+            return T(0);
+        }
+        int e;
+        if (x == T(0)) e = binary_exponent(y);
+        else if (y == T(0)) e = binary_exponent(x);
+        else e = std::max(binary_exponent(x), binary_exponent(y));
+
+        T a = scale_by_power_of_two(x, -e);
+        T b = scale_by_power_of_two(y, -e);
+        return scale_by_power_of_two(polySqrt(a * a + b * b), e);
+    }
+}
+
+// Batch variants: the same results as the scalar functions, bit for bit, for
+// every type; rsqrt reduces a group of lanes and advances their Newton steps
+// together so that the independent multiplications can overlap
+template <typename T>
+void rsqrt_batch(const T* in, T* out, size_t n) {
+    constexpr size_t lanes = 4;
+    size_t i = 0;
+    for (; i + lanes <= n; i += lanes) {
+        T m[lanes], y[lanes];
+        int k[lanes];
+        for (size_t l = 0; l < lanes; ++l) {
+            if (!(in[i + l] > T(0))) throw std::domain_error("rsqrt of a non-positive input");
+            m[l] = sqrt_reduce(in[i + l], k[l]);
+            y[l] = goldschmidt_seed_rsqrt(m[l]);
+        }
+        for (int step = 0; step < goldschmidt_iterations<T>(); ++step) {
+            for (size_t l = 0; l < lanes; ++l) y[l] = y[l] * (T(1.5) - T(0.5) * m[l] * y[l] * y[l]);
+        }
+        for (size_t l = 0; l < lanes; ++l) out[i + l] = scale_by_power_of_two(y[l], -k[l]);
+    }
+    for (; i < n; ++i) out[i] = rsqrt(in[i]);
+}
+
+template <typename T>
+void cube_root_batch(const T* in, T* out, size_t n) {
+    for (size_t i = 0; i < n; ++i) out[i] = cube_root(in[i]);
+}
+
+template <typename T>
+void hypot_batch(const T* x, const T* y, T* out, size_t n) {
+    for (size_t i = 0; i < n; ++i) out[i] = safe_hypot(x[i], y[i]);
+}
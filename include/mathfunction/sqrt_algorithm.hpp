@@ -0,0 +1,37 @@
+#pragma once
+// sqrt_algorithm.hpp: run-time selection among the sqrt kernels
+#include <stdexcept>
+#include <string>
+#include <mathfunction/sqrt_kernels.hpp>
+
+// One value per kernel in sqrt_kernels.hpp, named after its kernel
+enum class sqrt_algorithm { basic, heron, bakhshali, cordic, exp, poly, goldschmidt };
+
+constexpr int sqrt_algorithm_count = 7;
+
+inline const char* sqrt_algorithm_name(sqrt_algorithm algorithm) {
+    static constexpr const char* names[] = { "basic", "heron", "bakhshali", "cordic", "exp", "poly", "goldschmidt" };
+    return names[static_cast<int>(algorithm)];
+}
+
+// Algorithm by kernel name; throws on names no kernel carries
+inline sqrt_algorithm parse_sqrt_algorithm(const std::string& name) {
+    for (int a = 0; a < sqrt_algorithm_count; ++a) {
+        if (name == sqrt_algorithm_name(static_cast<sqrt_algorithm>(a))) return static_cast<sqrt_algorithm>(a);
+    }
+    throw std::runtime_error("unknown sqrt algorithm " + name);
+}
+
+template <typename T>
+T sqrt_with(sqrt_algorithm algorithm, T x) {
+    switch (algorithm) {
+    case sqrt_algorithm::heron:       return heronSqrt(x);
+    case sqrt_algorithm::bakhshali:   return bakhshaliSqrt(x);
+    case sqrt_algorithm::cordic:      return cordicSqrt(x);
+    case sqrt_algorithm::exp:         return expSqrt(x);
+    case sqrt_algorithm::poly:        return polySqrt(x);
+    case sqrt_algorithm::goldschmidt: return goldschmidtSqrt(x);
+    case sqrt_algorithm::basic:
+    default:                          return calculate_sqrt(x);
+    }
+}
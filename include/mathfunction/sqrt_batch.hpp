@@ -0,0 +1,152 @@
+#pragma once
+// sqrt_batch.hpp: cache-blocked, multi-threaded square roots over contiguous arrays
+//
+// Arrays are cut into cache-sized blocks that worker threads take in a
+// fixed stride, so the split, and with it every result, is the same on
+// each run. Norms of posit arrays accumulate the squares in the quire
+// and round once before the final sqrt.
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include <mathfunction/goldschmidt.hpp>
+#include <mathfunction/sqrt_algorithm.hpp>
+#include <mathfunction/fast_sqrt.hpp>
+#include <mathfunction/exact_residual.hpp>
+#include <mathfunction/encoding.hpp>
+
+// Elements per block: a block of T stays within a 32KB L1 data cache
+template <typename T>
+constexpr size_t cache_block_elements() {
+    return std::max<size_t>(1, 32768 / sizeof(T));
+}
+
+// The hardware square root for IEEE types, and for the emulated posit and
+// fixpnt types the kernel fast_sqrt dispatches each input to from the
+// measured tables
+template <typename T>
+void sqrt_batch(const T* in, T* out, size_t n) {
+    if constexpr (std::is_floating_point_v<T>) {
+        for (size_t i = 0; i < n; ++i) out[i] = std::sqrt(in[i]);
+    } else {
+        for (size_t i = 0; i < n; ++i) out[i] = fast_sqrt(in[i]);
+    }
+}
+
+// Arrays shorter than this stay on the calling thread: starting workers would cost more than they save
+constexpr size_t parallel_min_elements = size_t(1) << 15;
+
+// Threads for the blocks of n elements: up to hardware_concurrency, or at most thread_count when given
+inline size_t block_worker_count(size_t n, size_t block_size, unsigned thread_count = 0) {
+    size_t blocks = (n + block_size - 1) / block_size;
+    return (thread_count > 0) ? std::min<size_t>(blocks, thread_count)
+        : (n < parallel_min_elements) ? 1 : std::min<size_t>(blocks, std::max(1u, std::thread::hardware_concurrency()));
+}
+
+// Run block(first, last, b) for every block b on up to hardware_concurrency threads,
+// or on at most thread_count when given
+template <typename BlockFunction>
+void for_each_block(size_t n, size_t block_size, BlockFunction block, unsigned thread_count = 0) {
+    size_t blocks = (n + block_size - 1) / block_size;
+    size_t workers = block_worker_count(n, block_size, thread_count);
+    auto worker = [&](size_t w) {
+        for (size_t b = w; b < blocks; b += workers) {
+            block(b * block_size, std::min(n, (b + 1) * block_size), b);
+        }
+    };
+    if (workers <= 1) {
+        if (blocks > 0) worker(0);
+        return;
+    }
+    std::vector<std::thread> threads;
+    for (size_t w = 0; w < workers; ++w) {
+        threads.emplace_back(worker, w);
+    }
+    for (auto& th : threads) {
+        if (th.joinable()) {
+            th.join();
+        }
+    }
+}
+
+// 2-norm of n values: sum of squares in a wide accumulator, then one sqrt
+template <typename T>
+T parallel_two_norm(const T* in, size_t n) {
+    if (n == 0) return T(0);
+    const size_t block_size = cache_block_elements<T>();
+    const size_t blocks = (n + block_size - 1) / block_size;
+
+    if constexpr (is_posit_v<T>) {
+        // fused: every square enters the quire exactly, the sum rounds once,
+        // and its root is rounded correctly so that the norm rounds only twice
+        using Quire = sw::universal::quire<is_posit_type<T>::total_bits, is_posit_type<T>::exponent_bits>;
+        std::vector<Quire> partial(blocks);
+        for_each_block(n, block_size, [&](size_t first, size_t last, size_t b) {
+            Quire q(0);
+            for (size_t i = first; i < last; ++i) q += sw::universal::quire_mul(in[i], in[i]);
+            partial[b] = q;
+        });
+        Quire q(0);
+        for (const auto& p : partial) q += p;
+        T sum;
+        sw::universal::convert(q.to_value(), sum);
+        return round_sqrt(sum, goldschmidtSqrt(sum));
+    } else {
+        // squares of float and fixpnt elements are exact in double; the sum of squares
+        // of a fixpnt array can exceed its range, so the sqrt is taken before rounding to T
+        using Accumulator = std::conditional_t<std::is_same_v<T, double>, long double, double>;
+        std::vector<Accumulator> partial(blocks);
+        for_each_block(n, block_size, [&](size_t first, size_t last, size_t b) {
+            Accumulator sum = 0;
+            for (size_t i = first; i < last; ++i) {
+                Accumulator x = static_cast<Accumulator>(in[i]);
+                sum += x * x;
+            }
+            partial[b] = sum;
+        });
+        Accumulator sum = 0;
+        for (Accumulator p : partial) sum += p;
+        return T(static_cast<double>(std::sqrt(sum)));
+    }
+}
+
+// kernel(x) of n raw encodings of T, decoded and encoded a block at a time;
+// false when the kernel rejected an input (negative, NaR), whose result is
+// then left as the encoding of zero
+template <typename T, typename Kernel>
+bool sqrt_batch_encoded(const encoding_word_t<T>* in, encoding_word_t<T>* out, size_t n, Kernel kernel) {
+    std::atomic<bool> ok{ true };
+    for_each_block(n, cache_block_elements<T>(), [&](size_t first, size_t last, size_t) {
+        for (size_t i = first; i < last; ++i) {
+            T v = decode<T>(in[i]);
+            try { v = kernel(v); } catch (const std::exception&) { v = T(0); ok = false; }
+            out[i] = encode(v);
+        }
+    });
+    return ok;
+}
+
+// Square roots of n raw encodings of T with the given algorithm; Goldschmidt
+// runs its multi-lane batch over each block
+template <typename T>
+bool sqrt_batch_encoded(sqrt_algorithm algorithm, const encoding_word_t<T>* in, encoding_word_t<T>* out, size_t n) {
+    if (algorithm != sqrt_algorithm::goldschmidt) {
+        return sqrt_batch_encoded<T>(in, out, n, [algorithm](T x) { return sqrt_with(algorithm, x); });
+    }
+    std::atomic<bool> ok{ true };
+    for_each_block(n, cache_block_elements<T>(), [&](size_t first, size_t last, size_t) {
+        std::vector<T> values(last - first);
+        for (size_t i = first; i < last; ++i) values[i - first] = decode<T>(in[i]);
+        try {
+            goldschmidtSqrt(values.data(), values.data(), values.size());
+            for (size_t i = first; i < last; ++i) out[i] = encode(values[i - first]);
+        } catch (const std::exception&) {
+            // element by element, to isolate the rejected inputs
+            if (!sqrt_batch_encoded<T>(in + first, out + first, last - first, [](T x) { return goldschmidtSqrt(x); })) ok = false;
+        }
+    });
+    return ok;
+}
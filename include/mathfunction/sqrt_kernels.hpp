@@ -0,0 +1,75 @@
+#pragma once
+// sqrt_kernels.hpp: the kernels and number types that the sweep tools iterate over
+//
+// Each kernel is a stateless functor with a name, so tools can loop over
+// every (algorithm, type) pair at compile time with for_each_kernel and
+// for_each_type instead of repeating the five-type blocks of the drivers.
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <mathfunction/basic.hpp>
+#include <mathfunction/heron.hpp>
+#include <mathfunction/bakhshali.hpp>
+#include <mathfunction/cordic.hpp>
+#include <mathfunction/exp_identity.hpp>
+#include <mathfunction/poly_sqrt.hpp>
+#include <mathfunction/goldschmidt.hpp>
+
+// Define the types
+using Posit16 = sw::universal::posit<16, 2>;
+using Posit32 = sw::universal::posit<32, 2>;
+using Fixpnt16 = sw::universal::fixpnt<16, 8>;
+using Float = float;
+using Double = double;
+
+template <typename T>
+struct number_type_name;
+template <> struct number_type_name<Posit16> { static constexpr const char* value = "Posit16"; };
+template <> struct number_type_name<Posit32> { static constexpr const char* value = "Posit32"; };
+template <> struct number_type_name<Fixpnt16> { static constexpr const char* value = "Fixpnt16"; };
+template <> struct number_type_name<Float> { static constexpr const char* value = "Float"; };
+template <> struct number_type_name<Double> { static constexpr const char* value = "Double"; };
+
+struct BasicKernel {
+    static constexpr const char* name = "basic";
+    template <typename T> T operator()(T x) const { return calculate_sqrt(x); }
+};
+struct HeronKernel {
+    static constexpr const char* name = "heron";
+    template <typename T> T operator()(T x) const { return heronSqrt(x); }
+};
+struct BakhshaliKernel {
+    static constexpr const char* name = "bakhshali";
+    template <typename T> T operator()(T x) const { return bakhshaliSqrt(x); }
+};
+struct CordicKernel {
+    static constexpr const char* name = "cordic";
+    template <typename T> T operator()(T x) const { return cordicSqrt(x); }
+};
+struct ExpKernel {
+    static constexpr const char* name = "exp";
+    template <typename T> T operator()(T x) const { return expSqrt(x); }
+};
+struct PolyKernel {
+    static constexpr const char* name = "poly";
+    template <typename T> T operator()(T x) const { return polySqrt(x); }
+};
+struct GoldschmidtKernel {
+    static constexpr const char* name = "goldschmidt";
+    template <typename T> T operator()(T x) const { return goldschmidtSqrt(x); }
+};
+
+using sweep_kernels = std::tuple<BasicKernel, HeronKernel, BakhshaliKernel, CordicKernel, ExpKernel, PolyKernel, GoldschmidtKernel>;
+using sweep_types = std::tuple<Posit16, Posit32, Fixpnt16, Float, Double>;
+
+// f(kernel) for every kernel
+template <typename F>
+void for_each_kernel(F&& f) {
+    std::apply([&](auto... kernel) { (f(kernel), ...); }, sweep_kernels{});
+}
+
+// f(std::type_identity<T>{}) for every number type
+template <typename F>
+void for_each_type(F&& f) {
+    std::apply([&](auto... value) { (f(std::type_identity<decltype(value)>{}), ...); }, sweep_types{});
+}
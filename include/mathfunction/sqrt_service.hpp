@@ -0,0 +1,128 @@
+#pragma once
+// sqrt_service.hpp: wire protocol of the local sqrt service
+//
+// A request header names the number type, the algorithm and the number of
+// raw encodings. Small payloads follow the header on the Unix domain socket
+// and the results follow the response header. Large payloads stay in a POSIX
+// shared memory object created by the client: inputs at offset 0, results
+// right after them, so neither side copies them through the socket.
+#include <cctype>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <mathfunction/sqrt_batch.hpp>
+
+constexpr uint32_t sqrt_service_magic = 0x4d465351;
+constexpr const char* sqrt_service_default_socket = "/tmp/mathfunction-sqrt.sock";
+// payloads of at least this many bytes travel through shared memory
+constexpr size_t sqrt_service_shm_threshold = 64 * 1024;
+
+struct sqrt_service_request {
+    uint32_t magic;
+    uint8_t type;         // index into sweep_types
+    uint8_t algorithm;    // sqrt_algorithm
+    uint8_t shared;       // payload in the shared memory object shm_name
+    uint8_t reserved;
+    uint64_t count;
+    char shm_name[48];
+};
+
+struct sqrt_service_response {
+    uint32_t magic;
+    int32_t status;       // 0, EINVAL for a malformed request, EDOM when a kernel rejected an input
+    uint64_t count;
+};
+
+constexpr int sqrt_service_type_count = static_cast<int>(std::tuple_size_v<sweep_types>);
+
+// Index into sweep_types by type name, case insensitive; throws on unknown names
+inline int parse_sqrt_service_type(const std::string& name) {
+    auto lower = [](std::string s) {
+        for (auto& c : s) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        return s;
+    };
+    int index = 0, found = -1;
+    for_each_type([&](auto type) {
+        using T = typename decltype(type)::type;
+        if (lower(number_type_name<T>::value) == lower(name)) found = index;
+        ++index;
+    });
+    if (found < 0) throw std::runtime_error("unknown number type " + name);
+    return found;
+}
+
+inline const char* sqrt_service_type_name(int type) {
+    const char* name = "";
+    int index = 0;
+    for_each_type([&](auto t) {
+        using T = typename decltype(t)::type;
+        if (index++ == type) name = number_type_name<T>::value;
+    });
+    return name;
+}
+
+// Bytes per encoding of sweep type index type
+inline size_t sqrt_service_encoding_size(int type) {
+    size_t size = 0;
+    int index = 0;
+    for_each_type([&](auto t) {
+        using T = typename decltype(t)::type;
+        if (index++ == type) size = sizeof(encoding_word_t<T>);
+    });
+    return size;
+}
+
+// inline payloads of more bytes than this are rejected
+constexpr size_t sqrt_service_inline_limit = size_t(1) << 30;
+
+// Payload bytes of a request into bytes; false when they would exceed limit.
+// The count is checked before it is multiplied, so a huge one cannot wrap around.
+inline bool sqrt_service_payload_bytes(const sqrt_service_request& header, size_t limit, size_t& bytes) {
+    size_t size = sqrt_service_encoding_size(header.type);
+    if (size == 0 || header.count > limit / size) return false;
+    bytes = static_cast<size_t>(header.count) * size;
+    return true;
+}
+
+// Square roots of count encodings of sweep type index type; returns the response status
+inline int sqrt_service_run(int type, sqrt_algorithm algorithm, const void* in, void* out, size_t count) {
+    int status = EINVAL;
+    int index = 0;
+    for_each_type([&](auto t) {
+        using T = typename decltype(t)::type;
+        using word = encoding_word_t<T>;
+        if (index++ != type) return;
+        status = sqrt_batch_encoded<T>(algorithm, static_cast<const word*>(in), static_cast<word*>(out), count) ? 0 : EDOM;
+    });
+    return status;
+}
+
+// Blocking socket transfers of exactly size bytes; false on EOF or error
+inline bool read_all(int fd, void* data, size_t size) {
+    auto* p = static_cast<char*>(data);
+    while (size > 0) {
+        ssize_t n = ::read(fd, p, size);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        p += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+inline bool write_all(int fd, const void* data, size_t size) {
+    const auto* p = static_cast<const char*>(data);
+    while (size > 0) {
+        ssize_t n = ::send(fd, p, size, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        p += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
@@ -0,0 +1,362 @@
+#pragma once
+// sweep_scheduler.hpp: NUMA-aware placement of sweep workers and of their buffers
+//
+// Workers are spread over the NUMA nodes in proportion to their CPUs and
+// pinned either to their node (placement nodes, the default, which leaves
+// the kernel free to balance inside a socket) or to one core each
+// (placement cores). The blocks of a sweep are cut into one contiguous
+// range per node, sized by its share of the workers; the workers of a node
+// share its range, and only once it is drained do they take blocks from
+// the other nodes, nearest first. A buffer from allocate() is touched first
+// with the same cut, so the pages of each range live on the node that works
+// on them, and a block run by another node is traffic between sockets:
+// that is what the scheduler counts and report() prints. Sweeps whose data
+// is not from allocate() print only their workers, with report_workers().
+// Which thread runs a block never changes what it computes, so results are
+// the same as those of for_each_block (sqrt_batch.hpp) on any placement.
+//
+// The placement is a spec, from the command line or from the
+// MATHFUNCTION_PLACEMENT environment variable:
+//
+//   none|nodes|cores[,threads=N][,nodes=0-1][,huge-pages][,local]
+//
+// threads defaults to one worker per allowed CPU of the chosen nodes,
+// huge-pages asks for transparent huge pages in allocate(), and local
+// keeps every node on its own range.
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <mathfunction/cpu_topology.hpp>
+#include <mathfunction/reduction.hpp>
+
+enum class placement_mode { none, nodes, cores };
+
+inline const char* placement_name(placement_mode mode) {
+    switch (mode) {
+    case placement_mode::none:  return "none";
+    case placement_mode::nodes: return "nodes";
+    case placement_mode::cores: return "cores";
+    }
+    return "unknown";
+}
+
+struct placement_options {
+    placement_mode mode = placement_mode::nodes;
+    unsigned threads = 0;            // 0: one per allowed CPU of the chosen nodes
+    std::vector<unsigned> nodes;     // node ids to run on; empty: all of them
+    bool huge_pages = false;         // transparent huge pages for allocate()
+    bool cross_node = true;          // idle workers take blocks of other nodes
+
+    static placement_options parse(const std::string& spec) {
+        placement_options options;
+        std::stringstream items(spec);
+        std::string item;
+        while (std::getline(items, item, ',')) {
+            size_t equals = item.find('=');
+            std::string key = item.substr(0, equals);
+            std::string value = (equals == std::string::npos) ? "" : item.substr(equals + 1);
+            if (key.empty()) continue;
+            if (key == "none") options.mode = placement_mode::none;
+            else if (key == "nodes" && equals == std::string::npos) options.mode = placement_mode::nodes;
+            else if (key == "cores") options.mode = placement_mode::cores;
+            else if (key == "threads" && !value.empty()) options.threads = static_cast<unsigned>(std::stoul(value));
+            else if (key == "nodes") options.nodes = parse_cpulist(value);
+            else if (key == "huge-pages") options.huge_pages = true;
+            else if (key == "local") options.cross_node = false;
+            else throw std::invalid_argument("unknown placement '" + item + "' in '" + spec + "'");
+        }
+        return options;
+    }
+
+    // MATHFUNCTION_PLACEMENT, or the defaults when it is not set
+    static placement_options from_environment() {
+        const char* spec = std::getenv("MATHFUNCTION_PLACEMENT");
+        return (spec != nullptr) ? parse(spec) : placement_options{};
+    }
+};
+
+// Node of the page holding address, or -1 when the kernel does not tell
+inline int page_node(const void* address) {
+#if defined(__linux__) && defined(SYS_get_mempolicy)
+    constexpr unsigned long mpol_f_node = 1, mpol_f_addr = 2;    // numaif.h
+    int node = -1;
+    if (syscall(SYS_get_mempolicy, &node, nullptr, 0ul, address, mpol_f_node | mpol_f_addr) == 0) return node;
+#else
+    (void)address;
+#endif
+    return -1;
+}
+
+// Anonymous mapping of n values of T whose pages are placed by the thread
+// that touches them first; from sweep_scheduler::allocate they are touched
+// already, by the node that owns each block
+template <typename T>
+class node_buffer {
+    static_assert(std::is_trivially_destructible_v<T>, "node_buffer does not run destructors");
+public:
+    node_buffer() = default;
+    node_buffer(size_t n, bool huge_pages) : count(n), length(std::max<size_t>(1, n * sizeof(T))) {
+        void* p = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p == MAP_FAILED) throw std::runtime_error(std::string("cannot map a sweep buffer: ") + std::strerror(errno));
+#ifdef MADV_HUGEPAGE
+        if (huge_pages) ::madvise(p, length, MADV_HUGEPAGE);
+#else
+        (void)huge_pages;
+#endif
+        base = static_cast<T*>(p);
+    }
+    node_buffer(node_buffer&& rhs) noexcept
+        : base(std::exchange(rhs.base, nullptr)), count(std::exchange(rhs.count, 0)), length(std::exchange(rhs.length, 0)) {}
+    node_buffer& operator=(node_buffer&& rhs) noexcept {
+        if (this != &rhs) {
+            unmap();
+            base = std::exchange(rhs.base, nullptr);
+            count = std::exchange(rhs.count, 0);
+            length = std::exchange(rhs.length, 0);
+        }
+        return *this;
+    }
+    node_buffer(const node_buffer&) = delete;
+    node_buffer& operator=(const node_buffer&) = delete;
+    ~node_buffer() { unmap(); }
+
+    T* data() { return base; }
+    const T* data() const { return base; }
+    size_t size() const { return count; }
+    T& operator[](size_t i) { return base[i]; }
+    const T& operator[](size_t i) const { return base[i]; }
+    T* begin() { return base; }
+    T* end() { return base + count; }
+
+private:
+    void unmap() {
+        if (base != nullptr) munmap(base, length);
+        base = nullptr;
+    }
+
+    T* base = nullptr;
+    size_t count = 0;
+    size_t length = 0;
+};
+
+struct placement_stats {
+    unsigned workers = 0;
+    unsigned pinned = 0;                  // workers whose affinity was set
+    std::vector<unsigned> node_workers;   // per position in the topology
+    std::vector<uint64_t> local_blocks;   // blocks of its own range a node ran
+    std::vector<uint64_t> remote_blocks;  // blocks a node took from the others
+    uint64_t local_elements = 0;
+    uint64_t remote_elements = 0;
+};
+
+class sweep_scheduler {
+public:
+    explicit sweep_scheduler(const placement_options& options = placement_options::from_environment(),
+                             const cpu_topology& topology = cpu_topology::detect())
+        : settings(options) {
+        for (const auto& node : topology.nodes) {
+            if (options.nodes.empty() || std::find(options.nodes.begin(), options.nodes.end(), node.id) != options.nodes.end()) {
+                layout.nodes.push_back(node);
+            }
+        }
+        for (unsigned id : options.nodes) {
+            if (std::none_of(layout.nodes.begin(), layout.nodes.end(), [id](const numa_node& node) { return node.id == id; })) {
+                throw std::invalid_argument("placement: node " + std::to_string(id) + " has no CPU this process may use");
+            }
+        }
+        if (layout.nodes.empty()) layout = cpu_topology::single_node(allowed_cpus());
+
+        // workers in proportion to the CPUs of each node, the remainder to the largest nodes
+        const size_t cpus = layout.cpu_count();
+        const size_t total = (options.threads > 0) ? options.threads : std::max<size_t>(1, cpus);
+        std::vector<size_t> share(layout.nodes.size());
+        size_t assigned = 0;
+        for (size_t k = 0; k < share.size(); ++k) {
+            share[k] = total * layout.nodes[k].cpus.size() / cpus;
+            assigned += share[k];
+        }
+        std::vector<size_t> by_size(share.size());
+        for (size_t k = 0; k < by_size.size(); ++k) by_size[k] = k;
+        std::stable_sort(by_size.begin(), by_size.end(), [&](size_t a, size_t b) { return layout.nodes[a].cpus.size() > layout.nodes[b].cpus.size(); });
+        for (size_t i = 0; assigned < total; i = (i + 1) % by_size.size(), ++assigned) ++share[by_size[i]];
+
+        totals.node_workers.assign(share.begin(), share.end());
+        for (size_t k = 0; k < share.size(); ++k) {
+            const auto& cores = layout.nodes[k].cpus;
+            for (size_t j = 0; j < share[k]; ++j) {
+                std::vector<unsigned> mask;
+                if (options.mode == placement_mode::cores) mask.push_back(cores[j % cores.size()]);
+                else if (options.mode == placement_mode::nodes) mask = cores;
+                slots.push_back({ k, std::move(mask) });
+            }
+            steal_order.push_back(layout.neighbours(k));
+        }
+        totals.workers = static_cast<unsigned>(slots.size());
+        reset_stats();
+    }
+
+    const cpu_topology& topology() const { return layout; }
+    const placement_options& options() const { return settings; }
+    unsigned workers() const { return static_cast<unsigned>(slots.size()); }
+    const placement_stats& stats() const { return totals; }
+
+    void reset_stats() {
+        totals.local_blocks.assign(layout.nodes.size(), 0);
+        totals.remote_blocks.assign(layout.nodes.size(), 0);
+        totals.local_elements = totals.remote_elements = 0;
+    }
+
+    // Run block(first, last, b) for every block b of [0, n) on the placed workers
+    template <typename BlockFunction>
+    void for_each_block(size_t n, size_t block_size, BlockFunction block) {
+        schedule(n, block_size, block, true);
+    }
+
+    // Run task(t) for every t in [0, tasks), one task per block
+    template <typename Task>
+    void run(size_t tasks, Task task) {
+        for_each_block(tasks, 1, [&](size_t t, size_t, size_t) { task(t); });
+    }
+
+    // n values of T, zero-initialized by the workers that later run each block of block_size of them
+    template <typename T>
+    node_buffer<T> allocate(size_t n, size_t block_size) {
+        node_buffer<T> buffer(n, settings.huge_pages);
+        T* data = buffer.data();
+        schedule(n, block_size, [data](size_t first, size_t last, size_t) {
+            std::memset(static_cast<void*>(data + first), 0, (last - first) * sizeof(T));
+        }, false);
+        return buffer;
+    }
+
+    // Workers per node and the blocks each ran since the last reset_stats, for
+    // sweeps whose data was not placed by allocate(): there a block run off its
+    // node says nothing about traffic between sockets
+    void report_workers(std::ostream& out) const {
+        report_placement(out);
+        for (size_t k = 0; k < layout.nodes.size(); ++k) {
+            out << "  node " << layout.nodes[k].id << ": " << totals.node_workers[k] << " workers, "
+                << totals.local_blocks[k] + totals.remote_blocks[k] << " blocks\n";
+        }
+        out << std::flush;
+    }
+
+    // Workers per node and the blocks that crossed nodes since the last reset_stats;
+    // bytes_per_element turns the crossed elements into bytes
+    void report(std::ostream& out, size_t bytes_per_element = 0) const {
+        report_placement(out);
+        uint64_t local = 0, remote = 0;
+        for (size_t k = 0; k < layout.nodes.size(); ++k) {
+            out << "  node " << layout.nodes[k].id << ": " << totals.node_workers[k] << " workers, "
+                << totals.local_blocks[k] << " blocks of its own, " << totals.remote_blocks[k] << " from other nodes\n";
+            local += totals.local_blocks[k];
+            remote += totals.remote_blocks[k];
+        }
+        const uint64_t blocks = local + remote;
+        out << "  cross-node: " << remote << " of " << blocks << " blocks (" << std::fixed << std::setprecision(2)
+            << (blocks > 0 ? 100.0 * double(remote) / double(blocks) : 0.0) << "%), " << totals.remote_elements << " elements";
+        if (bytes_per_element > 0) out << ", " << std::setprecision(1) << double(totals.remote_elements * bytes_per_element) / (1024.0 * 1024.0) << " MB";
+        out << std::defaultfloat << std::endl;
+    }
+
+private:
+    void report_placement(std::ostream& out) const {
+        out << "placement: " << placement_name(settings.mode) << ", " << totals.workers << " workers on "
+            << layout.nodes.size() << (layout.nodes.size() == 1 ? " node" : " nodes") << ", " << totals.pinned << " pinned\n";
+    }
+
+    struct worker_slot {
+        size_t node;                   // position in the topology
+        std::vector<unsigned> cpus;    // affinity mask, empty for placement none
+    };
+    struct worker_counts {
+        uint64_t local_blocks = 0;
+        uint64_t remote_blocks = 0;
+        uint64_t local_elements = 0;
+        uint64_t remote_elements = 0;
+        bool pinned = false;
+    };
+
+    template <typename BlockFunction>
+    void schedule(size_t n, size_t block_size, BlockFunction&& block, bool count) {
+        const size_t blocks = (n + block_size - 1) / block_size;
+        if (blocks == 0) return;
+
+        // node k owns blocks [cursor[k], end[k]), cut by its share of the workers
+        const size_t nodes = layout.nodes.size();
+        std::vector<padded<std::atomic<size_t>>> cursor(nodes);
+        std::vector<size_t> end(nodes);
+        size_t before = 0;
+        for (size_t k = 0; k < nodes; ++k) {
+            cursor[k].value.store(blocks * before / slots.size());
+            before += totals.node_workers[k];
+            end[k] = blocks * before / slots.size();
+        }
+
+        std::vector<padded<worker_counts>> counts(slots.size());
+        auto worker = [&](size_t w) {
+            const worker_slot& slot = slots[w];
+            worker_counts& c = counts[w].value;
+            if (!slot.cpus.empty()) c.pinned = pin_current_thread(slot.cpus);
+            auto drain = [&](size_t k, uint64_t& taken, uint64_t& elements) {
+                for (size_t b = cursor[k].value++; b < end[k]; b = cursor[k].value++) {
+                    size_t first = b * block_size, last = std::min(n, first + block_size);
+                    block(first, last, b);
+                    ++taken;
+                    elements += last - first;
+                }
+            };
+            drain(slot.node, c.local_blocks, c.local_elements);
+            if (settings.cross_node) {
+                for (size_t k : steal_order[slot.node]) drain(k, c.remote_blocks, c.remote_elements);
+            }
+        };
+        if (slots.size() == 1 && slots[0].cpus.empty()) {
+            worker(0);
+        } else {
+            std::vector<std::thread> threads;
+            for (size_t w = 0; w < slots.size(); ++w) {
+                threads.emplace_back(worker, w);
+            }
+            for (auto& th : threads) {
+                if (th.joinable()) {
+                    th.join();
+                }
+            }
+        }
+
+        if (!count) return;
+        totals.pinned = 0;
+        for (size_t w = 0; w < slots.size(); ++w) {
+            const worker_counts& c = counts[w].value;
+            totals.pinned += c.pinned;
+            totals.local_blocks[slots[w].node] += c.local_blocks;
+            totals.remote_blocks[slots[w].node] += c.remote_blocks;
+            totals.local_elements += c.local_elements;
+            totals.remote_elements += c.remote_elements;
+        }
+    }
+
+    placement_options settings;
+    cpu_topology layout;
+    std::vector<worker_slot> slots;
+    std::vector<std::vector<size_t>> steal_order;    // per node, the others nearest first
+    placement_stats totals;
+};
@@ -0,0 +1,59 @@
+#pragma once
+// ulp.hpp: units in the last place and correctly rounded reference roots per type
+#include <cmath>
+#include <limits>
+#include <mathfunction/number_traits.hpp>
+
+// Next representable value above v
+template <typename T>
+T next_up(T v) {
+    if constexpr (std::is_floating_point_v<T>) {
+        return std::nextafter(v, std::numeric_limits<T>::infinity());
+    } else {
+        // posit and fixpnt increment to the next encoding
+        T n = v;
+        ++n;
+        return n;
+    }
+}
+
+// Next representable value below v
+template <typename T>
+T next_down(T v) {
+    if constexpr (std::is_floating_point_v<T>) {
+        return std::nextafter(v, -std::numeric_limits<T>::infinity());
+    } else {
+        T n = v;
+        --n;
+        return n;
+    }
+}
+
+// Spacing of T at v
+template <typename T>
+long double ulp_at(T v) {
+    return static_cast<long double>(next_up(v)) - static_cast<long double>(v);
+}
+
+// exact_residual.hpp, included below: it needs next_up and next_down
+template <typename T>
+T round_sqrt(const T& x, T y);
+
+// sqrt(x) rounded to T. The long double root reaches T through double, and
+// rounding twice can miss near a tie, so round_sqrt settles it on the exact
+// residuals
+template <typename T>
+T correctly_rounded_sqrt(T x) {
+    return round_sqrt(x, T(static_cast<double>(std::sqrt(static_cast<long double>(x)))));
+}
+
+// |result - sqrt(x)| in units of the last place of the correctly rounded root
+template <typename T>
+double ulp_error(T result, T x) {
+    long double exact = std::sqrt(static_cast<long double>(x));
+    long double ulp = ulp_at(correctly_rounded_sqrt(x));
+    if (ulp <= 0) return 0.0;
+    return static_cast<double>(std::fabs(static_cast<long double>(result) - exact) / ulp);
+}
+
+#include <mathfunction/exact_residual.hpp>
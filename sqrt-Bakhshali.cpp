@@ -9,6 +9,10 @@
 #include <sstream>
 #include <bitset>
 
+#include <mathfunction/bakhshali.hpp>
+
+#include <mathfunction/perf_counters.hpp>
+
 // Define the types
 using Posit16 = sw::universal::posit<16, 2>;
 using Posit32 = sw::universal::posit<32, 2>;
@@ -17,27 +21,6 @@ using Fixpnt16 = sw::universal::fixpnt<16, 8>;
 using Float = float;
 using Double = double;
 
-// Bakhshali square root function
-template <typename T>
-T bakhshaliSqrt(T S, T initialGuess = T(1.0), T tolerance = T(1e-10), int maxIterations = 1000) {
-    T x = initialGuess;
-    int iterations = 0;
-
-    while (iterations < maxIterations) {
-        T a = (S - x * x) / (T(2.0) * x);
-        T b = x + a;
-        x = b - (a * a) / (T(2.0) * b);
-
-        if (abs(a) < tolerance) {
-            break;
-        }
-
-        iterations++;
-    }
-
-    return x;
-}
-
 // Function to write data to CSV file
 void write_to_csv(const std::string& filename, const std::vector<std::vector<std::string>>& data) {
     std::ofstream file(filename);
@@ -141,10 +124,15 @@ void process_range(double scale_factor, const std::string& filename) {
         ""
     });
 
+    // Hardware counters per type, read once per batch, with MATHFUNCTION_PROFILE
+    profile_range<Posit16, Posit32, Fixpnt16, Float, Double>("bakhshali", { "Posit16", "Posit32", "Fixpnt16", "Float", "Double" },
+        scale_factor, bitset_size, [](auto x) { return bakhshaliSqrt(x); }, csv_data);
+
     write_to_csv(filename, csv_data);
 }
 
 int main() {
+    profile_scope profile;   // run totals of the counters at the end, with MATHFUNCTION_PROFILE
     // Different scale factors for different ranges close to zero
     const std::vector<double> scale_factors = {1.0e-5, 1.0e-6, 1.0e-7, 1.0e-8, 1.0e-9};//1.0e-10
     const std::vector<std::string> filenames = {
@@ -159,5 +147,6 @@ int main() {
         process_range(scale_factors[i], filenames[i]);
     }
 
+
     return 0;
 }
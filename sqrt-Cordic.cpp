@@ -8,9 +8,13 @@
 #include <string>
 #include <sstream>
 #include <bitset>
-#include <thread>
 #include <vector>
 
+#include <mathfunction/cordic.hpp>
+#include <mathfunction/sweep_scheduler.hpp>
+
+#include <mathfunction/perf_counters.hpp>
+
 // Define the types
 using Posit16 = sw::universal::posit<16, 2>;
 using Posit32 = sw::universal::posit<32, 2>;
@@ -19,34 +23,6 @@ using Fixpnt16 = sw::universal::fixpnt<16, 8>;
 using Float = float;
 using Double = double;
 
-template <typename T>
-T cordicSqrt(T x) {
-    if (x < T(0)) {
-        throw std::domain_error("Negative input not allowed");
-    }
-    if (x == T(0)) {
-        return T(0);
-    }
-
-    // Initialize result and iteration variable
-    T result = T(0);
-    T step = x; // Start with the value itself as the step
-
-    while (step > T(1)) {
-        step = step / T(2);
-    }
-
-    while (step != T(0)) {
-        T temp = result + step;
-        if (temp * temp <= x) {
-            result = temp;
-        }
-        step = step / T(2);
-    }
-
-    return result;
-}
-
 // Function to write data to CSV file
 void write_to_csv(const std::string& filename, const std::vector<std::vector<std::string>>& data) {
     std::ofstream file(filename);
@@ -150,11 +126,16 @@ void process_range(double scale_factor, const std::string& filename) {
         ""
     });
 
+    // Hardware counters per type, read once per batch, with MATHFUNCTION_PROFILE
+    profile_range<Posit16, Posit32, Fixpnt16, Float, Double>("cordic", { "Posit16", "Posit32", "Fixpnt16", "Float", "Double" },
+        scale_factor, bitset_size, [](auto x) { return cordicSqrt(x); }, csv_data);
+
     write_to_csv(filename, csv_data);
 }
 
 
 int main() {
+    profile_scope profile;   // run totals of the counters at the end, with MATHFUNCTION_PROFILE
     const std::vector<double> scale_factors = {1.0e-5, 1.0e-6, 1.0e-7, 1.0e-8, 1.0e-9};
     const std::vector<std::string> filenames = {
         "sqrt_comparison_cordic_range1.csv",
@@ -164,18 +145,10 @@ int main() {
         "sqrt_comparison_cordic_range5.csv"
     };
 
-    std::vector<std::thread> threads;
-
-    for (size_t i = 0; i < scale_factors.size(); ++i) {
-        threads.emplace_back(process_range, scale_factors[i], filenames[i]);
-    }
-
-    // Join all threads
-    for (auto& th : threads) {
-        if (th.joinable()) {
-            th.join();
-        }
-    }
+    // One range per task, on workers placed by MATHFUNCTION_PLACEMENT
+    sweep_scheduler scheduler;
+    scheduler.run(scale_factors.size(), [&](size_t i) { process_range(scale_factors[i], filenames[i]); });
+    scheduler.report_workers(std::cout);
 
     return 0;
 }
\ No newline at end of file
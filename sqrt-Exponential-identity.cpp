@@ -9,6 +9,11 @@
 #include <sstream>
 #include <bitset>
 
+#include <mathfunction/exp_identity.hpp>
+#include <mathfunction/poly_sqrt.hpp>
+
+#include <mathfunction/perf_counters.hpp>
+
 // Define the types
 using Posit16 = sw::universal::posit<16, 2>;
 using Posit32 = sw::universal::posit<32, 2>;
@@ -16,20 +21,6 @@ using Fixpnt16 = sw::universal::fixpnt<16, 8>;
 using Float = float;
 using Double = double;
 
-template <typename T>
-T expSqrt(T S) {
-    // Avoiding negative values
-    if (S < 0) {
-        throw std::runtime_error("Negative value encountered in expSqrt");
-    }
-    // Convert to double for log and exp calculations
-    double S_double = static_cast<double>(S);
-    double result_double = std::exp(0.5 * std::log(S_double));
-    // Convert back to the original type if necessary
-    return static_cast<T>(result_double);
-}
-
-
 // Function to write data to CSV file
 void write_to_csv(const std::string& filename, const std::vector<std::vector<std::string>>& data) {
     std::ofstream file(filename);
@@ -46,7 +37,8 @@ void write_to_csv(const std::string& filename, const std::vector<std::vector<std
 }
 
 // Function to process range and save results in a CSV file
-void process_range(double scale_factor, const std::string& filename) {
+template <typename Kernel>
+void process_range(const std::string& algorithm, double scale_factor, const std::string& filename, Kernel sqrtKernel) {
     const int bitset_size = 16; // Number of bits to iterate over
     std::cout << std::scientific << std::setprecision(15);
 
@@ -84,15 +76,15 @@ void process_range(double scale_factor, const std::string& filename) {
         Double sqrt_d;
 
         try {
-            sqrt_p16 = expSqrt(p16);
-            sqrt_p32 = expSqrt(p32);
+            sqrt_p16 = sqrtKernel(p16);
+            sqrt_p32 = sqrtKernel(p32);
             if (f16 >= 0) { // Ensure non-negative value for Fixpnt16
-                sqrt_f16 = expSqrt(f16);
+                sqrt_f16 = sqrtKernel(f16);
             } else {
                 throw std::runtime_error("Fixpnt16 value is negative");
             }
-            sqrt_f = expSqrt(f);
-            sqrt_d = expSqrt(d);
+            sqrt_f = sqrtKernel(f);
+            sqrt_d = sqrtKernel(d);
         } catch (const std::exception& e) {
             std::cerr << "Error calculating sqrt: " << e.what() << " for value: " << double_value << std::endl;
             continue;
@@ -137,10 +129,15 @@ void process_range(double scale_factor, const std::string& filename) {
         ""
     });
 
+    // Hardware counters per type, read once per batch, with MATHFUNCTION_PROFILE
+    profile_range<Posit16, Posit32, Fixpnt16, Float, Double>(algorithm, { "Posit16", "Posit32", "Fixpnt16", "Float", "Double" },
+        scale_factor, bitset_size, sqrtKernel, csv_data);
+
     write_to_csv(filename, csv_data);
 }
 
 int main() {
+    profile_scope profile;   // run totals of the counters at the end, with MATHFUNCTION_PROFILE
     // Different scale factors for different ranges close to zero
     const std::vector<double> scale_factors = {1e-5, 1e-6, 1e-7, 1e-8, 1e-9};
     const std::vector<std::string> filenames = {
@@ -151,8 +148,19 @@ int main() {
         "sqrt_comparison_exp_range5.csv"
     };
 
+    const std::vector<std::string> poly_filenames = {
+        "sqrt_comparison_poly_range1.csv",
+        "sqrt_comparison_poly_range2.csv",
+        "sqrt_comparison_poly_range3.csv",
+        "sqrt_comparison_poly_range4.csv",
+        "sqrt_comparison_poly_range5.csv"
+    };
+
     for (size_t i = 0; i < scale_factors.size(); ++i) {
-        process_range(scale_factors[i], filenames[i]);
+        // log/exp in double, the reference for the identity-based kernels
+        process_range("exp", scale_factors[i], filenames[i], [](auto x) { return expSqrt(x); });
+        // exponent halving and minimax polynomial, native in each type
+        process_range("poly", scale_factors[i], poly_filenames[i], [](auto x) { return polySqrt(x); });
     }
 
     return 0;
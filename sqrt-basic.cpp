@@ -9,6 +9,10 @@
 #include <sstream>
 #include <bitset>
 
+#include <mathfunction/basic.hpp>
+
+#include <mathfunction/perf_counters.hpp>
+
 // Define the types
 using Posit16 = sw::universal::posit<16, 2>;
 using Posit32 = sw::universal::posit<32, 2>;
@@ -16,21 +20,6 @@ using Fixpnt16 = sw::universal::fixpnt<16, 8>;
 using Float = float;
 using Double = double;
 
-// Template square root calculation
-template <typename T>
-T calculate_sqrt(T value) {
-    if constexpr (std::is_same_v<T, Posit16> || std::is_same_v<T, Posit32>) {
-        return sqrt(value);
-    } else if constexpr (std::is_same_v<T, Fixpnt16>) {
-        if (value < 0) {
-            throw sw::universal::fixpnt_arithmetic_exception("argument to sqrt is negative");
-        }
-        return sw::universal::sqrt(value);
-    } else {
-        return sqrt(value);
-    }
-}
-
 // Function to print results
 template <typename T>
 void print_result(const std::string& type_name, T value, T result) {
@@ -153,10 +142,15 @@ void process_range(double scale_factor, const std::string& filename) {
         ""
     });
 
+    // Hardware counters per type, read once per batch, with MATHFUNCTION_PROFILE
+    profile_range<Posit16, Posit32, Fixpnt16, Float, Double>("basic", { "Posit16", "Posit32", "Fixpnt16", "Float", "Double" },
+        scale_factor, bitset_size, [](auto x) { return calculate_sqrt(x); }, csv_data);
+
     write_to_csv(filename, csv_data);
 }
 
 int main() {
+    profile_scope profile;   // run totals of the counters at the end, with MATHFUNCTION_PROFILE
     // Different scale factors for different ranges close to zero
     const std::vector<double> scale_factors = {1e-5, 1e-6, 1e-7, 1e-8, 1e-9};
 
@@ -172,5 +166,6 @@ int main() {
         process_range(scale_factors[i], filenames[i]);
     }
 
+
     return 0;
 }
@@ -9,6 +9,10 @@
 #include <sstream>
 #include <bitset>
 
+#include <mathfunction/heron.hpp>
+
+#include <mathfunction/perf_counters.hpp>
+
 // Define the types
 using Posit16 = sw::universal::posit<16, 2>;
 using Posit32 = sw::universal::posit<32, 2>;
@@ -16,27 +20,6 @@ using Fixpnt16 = sw::universal::fixpnt<16, 8>;
 using Float = float;
 using Double = double;
 
-// Babylonian - Heron's square root function
-template <typename T>
-T heronSqrt(T S, T initialGuess = T(1.0), T tolerance = T(1e-10), int maxIterations = 1000) {
-    T x = initialGuess;
-    T prevX;
-    int iterations = 0;
-
-    while (iterations < maxIterations) {
-        prevX = x;
-        x = (x + S / x) / T(2.0);
-
-        if (abs(x - prevX) < tolerance) {
-            break;
-        }
-
-        iterations++;
-    }
-
-    return x;
-}
-
 // Function to write data to CSV file
 void write_to_csv(const std::string& filename, const std::vector<std::vector<std::string>>& data) {
     std::ofstream file(filename);
@@ -144,10 +127,15 @@ void process_range(double scale_factor, const std::string& filename) {
         ""
     });
 
+    // Hardware counters per type, read once per batch, with MATHFUNCTION_PROFILE
+    profile_range<Posit16, Posit32, Fixpnt16, Float, Double>("heron", { "Posit16", "Posit32", "Fixpnt16", "Float", "Double" },
+        scale_factor, bitset_size, [](auto x) { return heronSqrt(x); }, csv_data);
+
     write_to_csv(filename, csv_data);
 }
 
 int main() {
+    profile_scope profile;   // run totals of the counters at the end, with MATHFUNCTION_PROFILE
     // Different scale factors for different ranges close to zero
     const std::vector<double> scale_factors = {1e-5, 1e-6, 1e-7, 1e-8, 1e-9};
     const std::vector<std::string> filenames = {
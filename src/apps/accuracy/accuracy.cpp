@@ -0,0 +1,251 @@
+// Accuracy matrix: ULP statistics of every (algorithm, type) pair over a dense input sweep
+//
+//   accuracy [--cache sqrt_cache] [--no-cache] [--samples 262144]
+//            [--inputs log_uniform|uniform|boundaries|encodings|midpoints]
+//            [--adaptive [--budget 65536] [--threshold 1]]
+//            [--placement nodes|cores|none[,threads=N][,nodes=0-1][,local]]
+//
+// By default the 16-bit types are swept over every positive encoding, the
+// wider types over log-uniform samples of [1e-9, 1e9] from a fixed seed;
+// --inputs picks one generator for all types, encodings for the 16-bit ones
+// only. Kernel results come from the persistent result cache where present,
+// so after a change to one kernel only that kernel is recomputed. The
+// (algorithm, type) tasks run on NUMA-placed workers (sweep_scheduler.hpp).
+// Only the workers are placed: the inputs of a type are built once on the
+// main thread and shared by its tasks, and the results of a task are
+// allocated by whichever worker runs it.
+//
+// --adaptive replaces the fixed sweep with a refinement over the whole
+// dynamic range of each type (adaptive_sampler.hpp): at most --budget
+// kernel calls per pair, concentrated on the bands whose error is above
+// --threshold ulps, which are written to sqrt_error_bands.csv. Since the
+// samples crowd into those bands, the matrix then keeps only the largest
+// error and the failures; the moments, quantiles and correctly rounded
+// fraction are left blank and read per band from the bands file.
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <functional>
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <vector>
+#include <string>
+
+#include <mathfunction/sqrt_kernels.hpp>
+#include <mathfunction/result_cache.hpp>
+#include <mathfunction/input_generator.hpp>
+#include <mathfunction/ulp.hpp>
+#include <mathfunction/exact_residual.hpp>
+#include <mathfunction/error_stats.hpp>
+#include <mathfunction/sweep_scheduler.hpp>
+#include <mathfunction/adaptive_sampler.hpp>
+
+// Function to write data to CSV file
+void write_to_csv(const std::string& filename, const std::vector<std::vector<std::string>>& data) {
+    std::ofstream file(filename);
+    for (const auto& row : data) {
+        for (size_t i = 0; i < row.size(); ++i) {
+            file << row[i];
+            if (i < row.size() - 1) {
+                file << ",";
+            }
+        }
+        file << "\n";
+    }
+    file.close();
+}
+
+// Positive inputs of the named generator, or of the default sweep of T when empty
+template <typename T>
+std::vector<T> sweep_inputs(const std::string& generator, size_t samples) {
+    input_options options;
+    options.samples = samples;
+    std::string name = generator.empty() ? "encodings" : generator;
+    // 2^32 and more encodings do not fit a dense sweep
+    if (name == "encodings" && encoding_bits<T>() > 16) name = "log_uniform";
+    std::vector<T> inputs = make_input_generator<T>(name, options)->generate();
+    inputs.erase(std::remove_if(inputs.begin(), inputs.end(), [](const T& x) { return !(x > T(0)); }), inputs.end());
+    return inputs;
+}
+
+struct accuracy_row {
+    std::string algorithm;
+    std::string type_name;
+    size_t inputs = 0;
+    error_stats stats;
+    double correctly_rounded = 0.0;
+    uint64_t encodings = 0;                         // adaptive: positive encodings of the type
+    std::vector<std::vector<std::string>> bands;    // adaptive: one csv row per error band
+};
+
+template <typename T, typename Kernel>
+accuracy_row measure(result_cache& cache, const Kernel& kernel, const std::vector<T>& inputs) {
+    accuracy_row row;
+    row.algorithm = kernel.name;
+    row.type_name = number_type_name<T>::value;
+    row.inputs = inputs.size();
+    std::vector<T> results;
+    std::vector<bool> failed;
+    cache.evaluate(kernel, number_type_name<T>::value, inputs, results, failed);
+
+    size_t exact = 0;
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        if (failed[i]) {
+            ++row.stats.failures;
+            continue;
+        }
+        double ulp = ulp_error(results[i], inputs[i]);
+        row.stats.add(std::isnan(ulp) ? INFINITY : ulp, static_cast<double>(inputs[i]));
+        if (is_correctly_rounded_sqrt(inputs[i], results[i])) ++exact;
+    }
+    if (row.stats.count > 0) {
+        row.correctly_rounded = double(exact) / row.stats.count;
+    }
+    return row;
+}
+
+// Refinement over every positive encoding of T, the kernel results from the cache
+template <typename T, typename Kernel>
+accuracy_row measure_adaptive(result_cache& cache, const Kernel& kernel, const adaptive_options& options) {
+    accuracy_row row;
+    row.algorithm = kernel.name;
+    row.type_name = number_type_name<T>::value;
+    adaptive_result map = adaptive_sweep<T>([&](const std::vector<T>& inputs, std::vector<double>& ulps) {
+        std::vector<T> results;
+        std::vector<bool> failed;
+        cache.evaluate(kernel, number_type_name<T>::value, inputs, results, failed);
+        for (size_t i = 0; i < inputs.size(); ++i) {
+            double ulp = failed[i] ? INFINITY : ulp_error(results[i], inputs[i]);
+            ulps[i] = std::isnan(ulp) ? INFINITY : ulp;
+        }
+    }, options);
+
+    row.inputs = map.calls;
+    row.encodings = map.encodings;
+    row.stats = map.stats<T>();
+    // band bounds in full, since the finest bands sit between neighbouring encodings
+    auto value = [](uint64_t encoding) {
+        return argument_text(static_cast<double>(decode<T>(static_cast<encoding_word_t<T>>(encoding))));
+    };
+    for (const auto& band : map.bands) {
+        const error_sample* worst = band.worst();
+        row.bands.push_back({ row.algorithm, row.type_name, value(band.first), value(band.last), std::to_string(band.depth),
+                              std::to_string(band.samples.size()), band.exhaustive ? "1" : "0", std::to_string(band.max_ulp()),
+                              worst ? value(worst->encoding) : "", std::to_string(band.mean()), std::to_string(band.stddev()),
+                              std::to_string(band.failures()) });
+    }
+    return row;
+}
+
+int main(int argc, char** argv)
+try {
+    std::string directory = "sqrt_cache";
+    bool use_cache = true;
+    size_t samples = size_t(1) << 18;
+    std::string generator;
+    placement_options placement = placement_options::from_environment();
+    bool adaptive = false;
+    adaptive_options refinement;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--cache" && i + 1 < argc) directory = argv[++i];
+        else if (arg == "--no-cache") use_cache = false;
+        else if (arg == "--samples" && i + 1 < argc) samples = std::stoul(argv[++i]);
+        else if (arg == "--inputs" && i + 1 < argc) generator = argv[++i];
+        else if (arg == "--placement" && i + 1 < argc) placement = placement_options::parse(argv[++i]);
+        else if (arg == "--adaptive") adaptive = true;
+        else if (arg == "--budget" && i + 1 < argc) refinement.budget = std::stoull(argv[++i]);
+        else if (arg == "--threshold" && i + 1 < argc) refinement.max_ulp = std::stod(argv[++i]);
+        else {
+            std::cerr << "Usage: accuracy [--cache directory] [--no-cache] [--samples n] [--inputs generator] [--placement spec]\n"
+                      << "                [--adaptive [--budget calls] [--threshold ulp]]" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+    if (!use_cache) {
+        directory = (std::filesystem::temp_directory_path() / ("sqrt_cache_" + std::to_string(getpid()))).string();
+    }
+    auto start = std::chrono::steady_clock::now();
+
+    // one task per (algorithm, type) pair, all sharing the cache
+    std::vector<accuracy_row> rows;
+    {
+        result_cache cache(directory);
+        if (!cache.enabled()) {
+            std::cerr << "accuracy: no kernel versions in this build, results are not cached" << std::endl;
+        }
+        std::vector<std::function<accuracy_row()>> tasks;
+        for_each_type([&](auto type) {
+            using T = typename decltype(type)::type;
+            if (adaptive) {
+                for_each_kernel([&](auto kernel) {
+                    tasks.push_back([&cache, kernel, refinement]() { return measure_adaptive<T>(cache, kernel, refinement); });
+                });
+                return;
+            }
+            auto inputs = std::make_shared<std::vector<T>>(sweep_inputs<T>(generator, samples));
+            for_each_kernel([&](auto kernel) {
+                tasks.push_back([&cache, kernel, inputs]() { return measure<T>(cache, kernel, *inputs); });
+            });
+        });
+
+        rows.resize(tasks.size());
+        sweep_scheduler scheduler(placement);
+        scheduler.run(tasks.size(), [&](size_t t) { rows[t] = tasks[t](); });
+        cache.flush();
+
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << std::fixed << std::setprecision(2) << "accuracy matrix in " << seconds << " s, "
+                  << cache.hits() << " cached results, " << cache.misses() << " computed" << std::endl;
+        scheduler.report_workers(std::cout);
+    }
+    if (!use_cache) std::filesystem::remove_all(directory);
+
+    std::vector<std::vector<std::string>> csv_data;
+    csv_data.push_back({"Algorithm", "Type", "Inputs", "Failures", "Max ULP", "Max ULP Argument", "Mean ULP", "ULP Std Dev",
+                        "ULP p50", "ULP p99", "ULP p99.9", "Correctly Rounded"});
+    std::cout << std::scientific << std::setprecision(3);
+    for (const auto& r : rows) {
+        const error_stats& s = r.stats;
+        if (adaptive) {
+            std::cout << std::setw(14) << r.algorithm << std::setw(10) << r.type_name << ": Max ULP: " << s.max_ulp
+                      << ", Failures: " << s.failures << "/" << r.inputs << std::endl;
+            csv_data.push_back({ r.algorithm, r.type_name, std::to_string(r.inputs), std::to_string(s.failures),
+                                 std::to_string(s.max_ulp), argument_text(s.max_ulp_argument), "", "", "", "", "", "" });
+            continue;
+        }
+        std::cout << std::setw(14) << r.algorithm << std::setw(10) << r.type_name << ": Max ULP: " << s.max_ulp
+                  << ", Mean ULP: " << s.mean << ", p99 ULP: " << s.quantile(0.99) << ", Correctly Rounded: " << r.correctly_rounded
+                  << ", Failures: " << s.failures << "/" << r.inputs << std::endl;
+        csv_data.push_back({ r.algorithm, r.type_name, std::to_string(r.inputs), std::to_string(s.failures),
+                             std::to_string(s.max_ulp), argument_text(s.max_ulp_argument), std::to_string(s.mean), std::to_string(std::sqrt(s.variance())),
+                             std::to_string(s.quantile(0.5)), std::to_string(s.quantile(0.99)), std::to_string(s.quantile(0.999)),
+                             std::to_string(r.correctly_rounded) });
+    }
+    write_to_csv("sqrt_accuracy.csv", csv_data);
+
+    if (adaptive) {
+        std::vector<std::vector<std::string>> bands;
+        bands.push_back({"Algorithm", "Type", "From", "To", "Depth", "Samples", "Exhaustive", "Max ULP", "Max ULP Argument",
+                         "Mean ULP", "ULP Std Dev", "Failures"});
+        uint64_t calls = 0;
+        long double encodings = 0;
+        for (const auto& r : rows) {
+            bands.insert(bands.end(), r.bands.begin(), r.bands.end());
+            calls += r.inputs;
+            encodings += r.encodings;
+        }
+        write_to_csv("sqrt_error_bands.csv", bands);
+        std::cout << std::defaultfloat << std::setprecision(4) << "adaptive sweep: " << calls << " kernel calls for "
+                  << static_cast<double>(encodings) << " positive encodings, " << bands.size() - 1 << " error bands" << std::endl;
+    }
+
+    return EXIT_SUCCESS;
+}
+catch (const std::exception& e) {
+    std::cerr << "accuracy: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+}
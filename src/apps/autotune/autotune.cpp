@@ -0,0 +1,197 @@
+// Precision autotuner: the narrowest number format and kernel that meet an error budget
+//
+//   autotune [--lo 1e-3] [--hi 1e3] [--max-rel-error 1e-3] [--samples 2000]
+//
+// Candidates are a compile-time grid of posit<n,es> (es 0..3) and
+// fixpnt<n,r> (r = n/4, n/2, 3n/4), n from 8 to 32 in steps of
+// MATHFUNCTION_AUTOTUNE_STEP, each combined with every sweep kernel. The
+// inputs are log-uniform over [lo, hi] and the error is measured against the
+// double root of the input itself, so a format that cannot hold the inputs
+// fails. Candidates are evaluated in parallel.
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <functional>
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <random>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <string>
+
+#include <mathfunction/sqrt_kernels.hpp>
+#include <mathfunction/perf_counters.hpp>
+
+#ifndef MATHFUNCTION_AUTOTUNE_STEP
+#define MATHFUNCTION_AUTOTUNE_STEP 4
+#endif
+
+constexpr unsigned grid_min_bits = 8;
+constexpr unsigned grid_max_bits = 32;
+constexpr unsigned grid_step = MATHFUNCTION_AUTOTUNE_STEP;
+constexpr size_t grid_sizes = (grid_max_bits - grid_min_bits) / grid_step + 1;
+
+// Function to write data to CSV file
+void write_to_csv(const std::string& filename, const std::vector<std::vector<std::string>>& data) {
+    std::ofstream file(filename);
+    for (const auto& row : data) {
+        for (size_t i = 0; i < row.size(); ++i) {
+            file << row[i];
+            if (i < row.size() - 1) {
+                file << ",";
+            }
+        }
+        file << "\n";
+    }
+    file.close();
+}
+
+template <typename T>
+std::string format_name() {
+    if constexpr (is_posit_v<T>) {
+        return "posit<" + std::to_string(is_posit_type<T>::total_bits) + "," + std::to_string(is_posit_type<T>::exponent_bits) + ">";
+    } else {
+        return "fixpnt<" + std::to_string(is_fixpnt_type<T>::total_bits) + "," + std::to_string(is_fixpnt_type<T>::fraction_bits) + ">";
+    }
+}
+
+template <typename T>
+unsigned format_bits() {
+    if constexpr (is_posit_v<T>) return is_posit_type<T>::total_bits;
+    else return static_cast<unsigned>(is_fixpnt_type<T>::total_bits);
+}
+
+template <unsigned nbits, typename F>
+void for_each_format_of_size(F& f) {
+    using namespace sw::universal;
+    f(std::type_identity<posit<nbits, 0>>{});
+    f(std::type_identity<posit<nbits, 1>>{});
+    f(std::type_identity<posit<nbits, 2>>{});
+    f(std::type_identity<posit<nbits, 3>>{});
+    f(std::type_identity<fixpnt<nbits, nbits / 4>>{});
+    f(std::type_identity<fixpnt<nbits, nbits / 2>>{});
+    f(std::type_identity<fixpnt<nbits, 3 * nbits / 4>>{});
+}
+
+template <typename F, size_t... I>
+void for_each_format(F&& f, std::index_sequence<I...>) {
+    (for_each_format_of_size<static_cast<unsigned>(grid_min_bits + I * grid_step)>(f), ...);
+}
+
+struct candidate_result {
+    std::string format;
+    std::string algorithm;
+    unsigned bits;
+    double max_rel_error;
+    double ns_per_op;
+};
+
+// Max relative error and cost of kernel on the inputs held in T
+template <typename T, typename Kernel>
+candidate_result evaluate(Kernel kernel, const std::vector<double>& values) {
+    candidate_result result{ format_name<T>(), kernel.name, format_bits<T>(), 0.0, 0.0 };
+    std::vector<T> inputs(values.begin(), values.end());
+    std::vector<T> roots(inputs.size());
+    try {
+        result.ns_per_op = best_ns_per_call([&]() {
+            for (size_t i = 0; i < inputs.size(); ++i) roots[i] = kernel(inputs[i]);
+        }, inputs.size());
+    } catch (const std::exception&) {
+        result.max_rel_error = INFINITY;
+        return result;
+    }
+    for (size_t i = 0; i < values.size(); ++i) {
+        double reference = std::sqrt(values[i]);
+        double error = std::abs(static_cast<double>(roots[i]) - reference) / reference;
+        result.max_rel_error = std::max(result.max_rel_error, std::isnan(error) ? INFINITY : error);
+    }
+    return result;
+}
+
+int main(int argc, char** argv)
+try {
+    double lo = 1e-3, hi = 1e3, budget = 1e-3;
+    size_t samples = 2000;
+    bool usage = false;
+    for (int i = 1; i < argc && !usage; i += 2) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) usage = true;
+        else if (arg == "--lo") lo = std::stod(argv[i + 1]);
+        else if (arg == "--hi") hi = std::stod(argv[i + 1]);
+        else if (arg == "--max-rel-error") budget = std::stod(argv[i + 1]);
+        else if (arg == "--samples") samples = std::stoul(argv[i + 1]);
+        else usage = true;
+    }
+    if (usage) {
+        std::cerr << "Usage: autotune [--lo x] [--hi x] [--max-rel-error e] [--samples n]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::mt19937_64 rng(0x5eed);
+    std::uniform_real_distribution<double> exponent(std::log2(lo), std::log2(hi));
+    std::vector<double> values(samples);
+    for (auto& x : values) x = std::exp2(exponent(rng));
+
+    // one task per (format, kernel) candidate
+    std::vector<std::function<candidate_result()>> tasks;
+    for_each_format([&](auto format) {
+        using T = typename decltype(format)::type;
+        for_each_kernel([&](auto kernel) {
+            tasks.push_back([kernel, &values]() { return evaluate<T>(kernel, values); });
+        });
+    }, std::make_index_sequence<grid_sizes>{});
+
+    std::vector<candidate_result> results(tasks.size());
+    std::atomic<size_t> next{ 0 };
+    auto worker = [&]() {
+        for (size_t t = next++; t < tasks.size(); t = next++) results[t] = tasks[t]();
+    };
+    std::vector<std::thread> threads;
+    for (unsigned w = 0; w < std::max(1u, std::thread::hardware_concurrency()); ++w) {
+        threads.emplace_back(worker);
+    }
+    for (auto& th : threads) {
+        if (th.joinable()) {
+            th.join();
+        }
+    }
+
+    // narrowest first, cheapest among equally wide formats
+    std::vector<candidate_result> passing;
+    for (const auto& r : results) {
+        if (r.max_rel_error <= budget) passing.push_back(r);
+    }
+    std::sort(passing.begin(), passing.end(), [](const candidate_result& a, const candidate_result& b) {
+        return (a.bits != b.bits) ? a.bits < b.bits : a.ns_per_op < b.ns_per_op;
+    });
+
+    std::cout << std::scientific << std::setprecision(3);
+    std::cout << tasks.size() << " candidates, " << passing.size() << " meet max relative error " << budget
+              << " on [" << lo << ", " << hi << "]" << std::endl;
+    for (size_t i = 0; i < std::min<size_t>(passing.size(), 10); ++i) {
+        const auto& r = passing[i];
+        std::cout << std::setw(16) << r.format << std::setw(14) << r.algorithm << ": " << r.ns_per_op
+                  << " ns/op, Max Relative Error: " << r.max_rel_error << std::endl;
+    }
+    if (passing.empty()) {
+        std::cout << "no candidate meets the budget" << std::endl;
+    } else {
+        std::cout << "narrowest: " << passing.front().format << " with " << passing.front().algorithm << std::endl;
+    }
+
+    std::vector<std::vector<std::string>> csv_data;
+    csv_data.push_back({"Format", "Bits", "Algorithm", "ns/op", "Max Relative Error", "Meets Budget"});
+    for (const auto& r : results) {
+        csv_data.push_back({ r.format, std::to_string(r.bits), r.algorithm, std::to_string(r.ns_per_op),
+                             std::to_string(r.max_rel_error), r.max_rel_error <= budget ? "yes" : "no" });
+    }
+    write_to_csv("sqrt_autotune.csv", csv_data);
+
+    return EXIT_SUCCESS;
+}
+catch (const std::exception& e) {
+    std::cerr << "autotune: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+}
@@ -0,0 +1,122 @@
+// Shift-add hyperbolic CORDIC against the bisection kernel on fixed-point formats
+//
+//   cordic [--samples 65536]
+//
+// For every format the square root of the shift-add engine and of the
+// multiply-based bisection (cordicSqrt) is timed and its error measured in
+// units of the format's last place; ln, exp and atanh of the same engine
+// are measured against the double precision library functions. A domain is
+// swept over every value of the format when it has at most --samples of
+// them, over evenly spaced samples otherwise.
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <vector>
+#include <string>
+
+#include <mathfunction/cordic.hpp>
+#include <mathfunction/hyperbolic_cordic.hpp>
+#include <mathfunction/error_stats.hpp>
+#include <mathfunction/perf_counters.hpp>
+
+// Function to write data to CSV file
+void write_to_csv(const std::string& filename, const std::vector<std::vector<std::string>>& data) {
+    std::ofstream file(filename);
+    for (const auto& row : data) {
+        for (size_t i = 0; i < row.size(); ++i) {
+            file << row[i];
+            if (i < row.size() - 1) {
+                file << ",";
+            }
+        }
+        file << "\n";
+    }
+    file.close();
+}
+
+// Inputs in [lo, hi] on a grid of spacing ulp: every value when there are at most samples of them
+template <typename T>
+std::vector<T> format_inputs(double lo, double hi, double ulp, size_t samples) {
+    const double steps = std::floor((hi - lo) / ulp);
+    std::vector<T> inputs;
+    if (steps <= static_cast<double>(samples)) {
+        for (double k = 0; k <= steps; ++k) inputs.push_back(T(lo + k * ulp));
+    } else {
+        for (size_t k = 0; k < samples; ++k) inputs.push_back(T(lo + (hi - lo) * static_cast<double>(k) / static_cast<double>(samples - 1)));
+    }
+    return inputs;
+}
+
+// Error in ulps of f against reference over inputs, and ns per call
+template <typename T>
+void measure(const std::string& format, double ulp, double range, const std::string& function, const std::string& method,
+             const std::vector<T>& inputs, const std::function<T(T)>& f, double (*reference)(double),
+             std::vector<std::vector<std::string>>& csv_data) {
+    std::vector<T> results(inputs.size());
+    double ns = best_ns_per_call([&]() {
+        for (size_t i = 0; i < inputs.size(); ++i) results[i] = f(inputs[i]);
+    }, inputs.size());
+
+    error_stats stats;
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        double exact = reference(static_cast<double>(inputs[i]));
+        // results the format cannot hold are saturated, not errors of the method
+        if (!(std::abs(exact) < range)) {
+            ++stats.skipped;
+            continue;
+        }
+        stats.add(std::abs(static_cast<double>(results[i]) - exact) / ulp, static_cast<double>(inputs[i]));
+    }
+    std::cout << std::setw(14) << format << std::setw(7) << function << std::setw(12) << method << ": " << std::fixed << std::setprecision(1)
+              << std::setw(8) << ns << " ns, " << std::setprecision(3) << "Max ULP: " << stats.max_ulp << " at " << stats.max_ulp_argument
+              << ", Mean ULP: " << stats.mean << ", Within Half ULP: " << stats.within_half_ulp() << std::endl;
+    csv_data.push_back({ format, function, method, std::to_string(stats.count), std::to_string(ns), std::to_string(stats.max_ulp),
+                         argument_text(stats.max_ulp_argument), std::to_string(stats.mean), std::to_string(stats.within_half_ulp()) });
+}
+
+template <unsigned nbits, unsigned rbits>
+void compare_format(size_t samples, std::vector<std::vector<std::string>>& csv_data) {
+    using T = sw::universal::fixpnt<nbits, rbits>;
+    const std::string format = "fixpnt<" + std::to_string(nbits) + "," + std::to_string(rbits) + ">";
+    const double ulp = std::ldexp(1.0, -static_cast<int>(rbits));
+    const double range = std::ldexp(1.0, static_cast<int>(nbits - rbits - 1)) - ulp;
+
+    std::vector<T> positive = format_inputs<T>(ulp, range, ulp, samples);
+    measure<T>(format, ulp, range, "sqrt", "bisection", positive, [](T x) { return cordicSqrt(x); }, [](double v) { return std::sqrt(v); }, csv_data);
+    measure<T>(format, ulp, range, "sqrt", "shift-add", positive, [](T x) { return hyperbolicCordicSqrt(x); }, [](double v) { return std::sqrt(v); }, csv_data);
+    measure<T>(format, ulp, range, "ln", "shift-add", positive, [](T x) { return hyperbolicCordicLog(x); }, [](double v) { return std::log(v); }, csv_data);
+    measure<T>(format, ulp, range, "exp", "shift-add", format_inputs<T>(-range, std::log(range), ulp, samples),
+               [](T x) { return hyperbolicCordicExp(x); }, [](double v) { return std::exp(v); }, csv_data);
+    measure<T>(format, ulp, range, "atanh", "shift-add", format_inputs<T>(ulp - 1.0, 1.0 - ulp, ulp, samples),
+               [](T x) { return hyperbolicCordicAtanh(x); }, [](double v) { return std::atanh(v); }, csv_data);
+}
+
+int main(int argc, char** argv)
+try {
+    size_t samples = size_t(1) << 16;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--samples" && i + 1 < argc) samples = std::max<size_t>(2, std::stoul(argv[++i]));
+        else {
+            std::cerr << "Usage: cordic [--samples n]" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    std::vector<std::vector<std::string>> csv_data;
+    csv_data.push_back({"Format", "Function", "Method", "Inputs", "ns/call", "Max ULP", "Max ULP Argument", "Mean ULP", "Within Half ULP"});
+    compare_format<16, 8>(samples, csv_data);
+    compare_format<16, 12>(samples, csv_data);
+    compare_format<24, 12>(samples, csv_data);
+    compare_format<32, 16>(samples, csv_data);
+    write_to_csv("sqrt_cordic.csv", csv_data);
+
+    return EXIT_SUCCESS;
+}
+catch (const std::exception& e) {
+    std::cerr << "cordic: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+}
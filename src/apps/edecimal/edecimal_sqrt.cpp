@@ -0,0 +1,78 @@
+// Precision-doubling against fixed-precision Newton for high-digit edecimal square roots
+#include <chrono>
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <vector>
+#include <string>
+
+#include <mathfunction/edecimal_sqrt.hpp>
+
+// Function to write data to CSV file
+void write_to_csv(const std::string& filename, const std::vector<std::vector<std::string>>& data) {
+    std::ofstream file(filename);
+    for (const auto& row : data) {
+        for (size_t i = 0; i < row.size(); ++i) {
+            file << row[i];
+            if (i < row.size() - 1) {
+                file << ",";
+            }
+        }
+        file << "\n";
+    }
+    file.close();
+}
+
+// Time both methods on floor(sqrt(2 * 10^(2 * digits))), i.e. sqrt(2) to the given digits
+template <typename Kernel>
+double time_kernel(Kernel kernel, const sw::universal::edecimal& n, sw::universal::edecimal& root) {
+    auto start = std::chrono::steady_clock::now();
+    root = kernel(n);
+    auto stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(stop - start).count();
+}
+
+int main(int argc, char** argv)
+try {
+    using sw::universal::edecimal;
+    std::cout << std::fixed << std::setprecision(3);
+
+    std::vector<std::vector<std::string>> csv_data;
+    csv_data.push_back({"Digits", "Doubling ms", "Fixed Newton ms", "Speedup", "Match"});
+
+    for (int digits : {100, 1000, 10000}) {
+        edecimal n;
+        n = 2;
+        n.shiftLeft(2 * digits);
+
+        edecimal doubling, fixed;
+        double doubling_ms = time_kernel([](const edecimal& x) { return edecimalSqrt(x); }, n, doubling);
+        double fixed_ms = time_kernel([](const edecimal& x) { return fixedNewtonSqrt(x); }, n, fixed);
+        bool match = (doubling == fixed);
+
+        std::cout << std::setw(6) << digits << " digits: doubling " << doubling_ms << " ms, fixed Newton "
+                  << fixed_ms << " ms, speedup " << fixed_ms / doubling_ms << (match ? "" : "  MISMATCH") << std::endl;
+        csv_data.push_back({ std::to_string(digits), std::to_string(doubling_ms), std::to_string(fixed_ms),
+                             std::to_string(fixed_ms / doubling_ms), match ? "yes" : "no" });
+    }
+
+    write_to_csv("edecimal_sqrt.csv", csv_data);
+
+    return EXIT_SUCCESS;
+}
+catch (const char* msg) {
+    std::cerr << msg << std::endl;
+    return EXIT_FAILURE;
+}
+catch (const sw::universal::universal_arithmetic_exception& err) {
+    std::cerr << "Unprocessed universal arithmetic exception: " << err.what() << std::endl;
+    return EXIT_FAILURE;
+}
+catch (const sw::universal::universal_internal_exception& err) {
+    std::cerr << "Unprocessed universal internal exception: " << err.what() << std::endl;
+    return EXIT_FAILURE;
+}
+catch (...) {
+    std::cerr << "Caught unknown exception" << std::endl;
+    return EXIT_FAILURE;
+}
@@ -0,0 +1,117 @@
+// Head-to-head comparison of Goldschmidt against the Heron and Bakhshali iterations
+#include <universal/number/posit/posit.hpp>
+#include <universal/number/fixpnt/fixpnt.hpp>
+#include <cmath>
+#include <chrono>
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <sstream>
+#include <bitset>
+
+#include <mathfunction/heron.hpp>
+#include <mathfunction/bakhshali.hpp>
+#include <mathfunction/goldschmidt.hpp>
+
+// Define the types
+using Posit16 = sw::universal::posit<16, 2>;
+using Posit32 = sw::universal::posit<32, 2>;
+using Fixpnt16 = sw::universal::fixpnt<16, 8>;
+using Float = float;
+using Double = double;
+
+// Function to write data to CSV file
+void write_to_csv(const std::string& filename, const std::vector<std::vector<std::string>>& data) {
+    std::ofstream file(filename);
+    for (const auto& row : data) {
+        for (size_t i = 0; i < row.size(); ++i) {
+            file << row[i];
+            if (i < row.size() - 1) {
+                file << ",";
+            }
+        }
+        file << "\n";
+    }
+    file.close();
+}
+
+// Time a batch kernel over the inputs and measure its error against the double sqrt
+template <typename T, typename BatchKernel>
+void compare(const std::string& algorithm, const std::string& type_name, const std::vector<double>& values,
+             BatchKernel kernel, std::vector<std::vector<std::string>>& csv_data) {
+    const int repetitions = 100;
+    // values that underflow to zero in T are left out: sqrt(0) says nothing about the kernels
+    std::vector<T> inputs;
+    for (double value : values) {
+        T x(value);
+        if (x > T(0)) inputs.push_back(x);
+    }
+    std::vector<T> results(inputs.size());
+
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < repetitions; ++r) {
+        kernel(inputs.data(), results.data(), inputs.size());
+    }
+    auto stop = std::chrono::steady_clock::now();
+    double ns_per_op = std::chrono::duration<double, std::nano>(stop - start).count() / (double(repetitions) * inputs.size());
+
+    double total_error = 0.0;
+    double max_rel_error = 0.0;
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        double reference = std::sqrt(static_cast<Double>(inputs[i]));
+        double error = std::abs(static_cast<Double>(results[i]) - reference);
+        total_error += error;
+        if (reference > 0) max_rel_error = std::max(max_rel_error, error / reference);
+    }
+    double avg_error = total_error / inputs.size();
+
+    std::cout << std::setw(12) << algorithm << std::setw(10) << type_name
+              << ": " << std::setw(12) << ns_per_op << " ns/op, Average Error: " << avg_error
+              << ", Max Relative Error: " << max_rel_error << std::endl;
+    csv_data.push_back({ algorithm, type_name, std::to_string(ns_per_op), std::to_string(avg_error), std::to_string(max_rel_error) });
+}
+
+// Run every kernel on one type
+template <typename T>
+void compare_kernels(const std::string& type_name, const std::vector<double>& values, std::vector<std::vector<std::string>>& csv_data) {
+    compare<T>("heron", type_name, values, [](const T* in, T* out, size_t n) {
+        for (size_t i = 0; i < n; ++i) out[i] = heronSqrt(in[i]);
+    }, csv_data);
+    compare<T>("bakhshali", type_name, values, [](const T* in, T* out, size_t n) {
+        for (size_t i = 0; i < n; ++i) out[i] = bakhshaliSqrt(in[i]);
+    }, csv_data);
+    compare<T>("goldschmidt", type_name, values, [](const T* in, T* out, size_t n) {
+        for (size_t i = 0; i < n; ++i) out[i] = goldschmidtSqrt(in[i]);
+    }, csv_data);
+    compare<T>("goldschmidt4", type_name, values, [](const T* in, T* out, size_t n) {
+        goldschmidtSqrt(in, out, n);
+    }, csv_data);
+}
+
+int main() {
+    const std::vector<double> scale_factors = {1.0, 1e-5, 1e-6, 1e-7, 1e-8, 1e-9};
+    const int bitset_size = 16; // Number of bits to iterate over
+    std::cout << std::scientific << std::setprecision(6);
+
+    std::vector<double> values;
+    for (double scale_factor : scale_factors) {
+        for (int i = 0; i < bitset_size; ++i) {
+            values.push_back(static_cast<double>(std::bitset<bitset_size>(1 << i).to_ulong()) * scale_factor);
+        }
+    }
+
+    std::vector<std::vector<std::string>> csv_data;
+    csv_data.push_back({"Algorithm", "Type", "ns/op", "Average Error", "Max Relative Error"});
+
+    compare_kernels<Posit16>("Posit16", values, csv_data);
+    compare_kernels<Posit32>("Posit32", values, csv_data);
+    compare_kernels<Fixpnt16>("Fixpnt16", values, csv_data);
+    compare_kernels<Float>("Float", values, csv_data);
+    compare_kernels<Double>("Double", values, csv_data);
+
+    write_to_csv("sqrt_comparison_goldschmidt.csv", csv_data);
+
+    return 0;
+}
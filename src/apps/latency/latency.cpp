@@ -0,0 +1,158 @@
+// Per-call latency distribution of every sqrt kernel and number type
+//
+//   latency [--samples N] [--trace inputs.bin]
+//
+// Each call is timed on its own with the time-stamp counter and recorded in
+// an HDR-style histogram per (distribution, algorithm, type). Distributions
+// are the scale ranges of the drivers, log-uniform over the type's dynamic
+// range, and optionally a recorded trace of native-endian doubles.
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <random>
+#include <vector>
+#include <string>
+#include <bitset>
+
+#include <mathfunction/sqrt_kernels.hpp>
+#include <mathfunction/perf_counters.hpp>
+#include <mathfunction/latency_histogram.hpp>
+
+// Function to write data to CSV file
+void write_to_csv(const std::string& filename, const std::vector<std::vector<std::string>>& data) {
+    std::ofstream file(filename);
+    for (const auto& row : data) {
+        for (size_t i = 0; i < row.size(); ++i) {
+            file << row[i];
+            if (i < row.size() - 1) {
+                file << ",";
+            }
+        }
+        file << "\n";
+    }
+    file.close();
+}
+
+// The inputs of the drivers: 16 powers of two per scale factor, repeated to the sample count
+std::vector<double> scale_range_inputs(size_t samples) {
+    const std::vector<double> scale_factors = {1e-5, 1e-6, 1e-7, 1e-8, 1e-9};
+    const int bitset_size = 16; // Number of bits to iterate over
+    std::vector<double> values;
+    for (double scale_factor : scale_factors) {
+        for (int i = 0; i < bitset_size; ++i) {
+            values.push_back(static_cast<double>(std::bitset<bitset_size>(1 << i).to_ulong()) * scale_factor);
+        }
+    }
+    std::vector<double> inputs(samples);
+    for (size_t i = 0; i < samples; ++i) inputs[i] = values[i % values.size()];
+    return inputs;
+}
+
+// Log-uniform over the positive range of T, clipped to [2^-30, 2^30]
+template <typename T>
+std::vector<double> log_uniform_inputs(size_t samples) {
+    double lo = std::max(-30.0, std::log2(static_cast<double>(std::numeric_limits<T>::min())));
+    double hi = std::min(30.0, std::log2(static_cast<double>(std::numeric_limits<T>::max())));
+    std::mt19937_64 rng(0x5eed);
+    std::uniform_real_distribution<double> exponent(lo, hi);
+    std::vector<double> inputs(samples);
+    for (auto& x : inputs) x = std::exp2(exponent(rng));
+    return inputs;
+}
+
+std::vector<double> trace_inputs(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("cannot open trace " + filename);
+    }
+    std::vector<double> inputs;
+    double x;
+    while (file.read(reinterpret_cast<char*>(&x), sizeof(x))) inputs.push_back(x);
+    return inputs;
+}
+
+// Time every call of kernel on the inputs converted to T
+template <typename T, typename Kernel>
+latency_histogram measure(Kernel kernel, const std::vector<double>& values, size_t& failures) {
+    std::vector<T> inputs(values.begin(), values.end());
+    std::vector<T> results(inputs.size());
+    const double ns_per_cycle = 1.0 / cycles_per_ns();
+
+    latency_histogram histogram;
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        try {
+            uint64_t begin = read_cycles();
+            results[i] = kernel(inputs[i]);
+            uint64_t end = read_cycles();
+            histogram.record(static_cast<uint64_t>((end - begin) * ns_per_cycle + 0.5));
+        } catch (const std::exception&) {
+            // the drivers skip inputs a kernel rejects; count them instead of timing them
+            ++failures;
+        }
+    }
+    return histogram;
+}
+
+int main(int argc, char** argv)
+try {
+    size_t samples = 10000;
+    std::string trace;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--samples" && i + 1 < argc) samples = std::stoul(argv[++i]);
+        else if (arg == "--trace" && i + 1 < argc) trace = argv[++i];
+        else {
+            std::cerr << "Usage: latency [--samples N] [--trace inputs.bin]" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+    const std::vector<double> trace_values = trace.empty() ? std::vector<double>{} : trace_inputs(trace);
+
+    std::vector<std::vector<std::string>> csv_data;
+    csv_data.push_back({"Distribution", "Algorithm", "Type", "Samples", "Failures", "p50 ns", "p90 ns", "p99 ns", "p99.9 ns", "max ns"});
+
+    std::cout << std::setw(12) << "Distribution" << std::setw(12) << "Algorithm" << std::setw(10) << "Type"
+              << std::setw(10) << "p50" << std::setw(10) << "p90" << std::setw(10) << "p99"
+              << std::setw(10) << "p99.9" << std::setw(12) << "max" << "  (ns)" << std::endl;
+
+    auto report = [&](const std::string& distribution, const char* algorithm, const char* type_name,
+                      const latency_histogram& h, size_t failures) {
+        std::cout << std::setw(12) << distribution << std::setw(12) << algorithm << std::setw(10) << type_name
+                  << std::setw(10) << h.percentile(0.5) << std::setw(10) << h.percentile(0.9)
+                  << std::setw(10) << h.percentile(0.99) << std::setw(10) << h.percentile(0.999)
+                  << std::setw(12) << h.max() << std::endl;
+        csv_data.push_back({ distribution, algorithm, type_name, std::to_string(h.count()), std::to_string(failures),
+                             std::to_string(h.percentile(0.5)), std::to_string(h.percentile(0.9)),
+                             std::to_string(h.percentile(0.99)), std::to_string(h.percentile(0.999)),
+                             std::to_string(h.max()) });
+    };
+
+    for_each_type([&](auto type) {
+        using T = typename decltype(type)::type;
+        const char* type_name = number_type_name<T>::value;
+        std::vector<std::pair<std::string, std::vector<double>>> distributions = {
+            { "ranges", scale_range_inputs(samples) },
+            { "log-uniform", log_uniform_inputs<T>(samples) }
+        };
+        if (!trace_values.empty()) distributions.push_back({ "trace", trace_values });
+
+        for (const auto& [distribution, values] : distributions) {
+            for_each_kernel([&](auto kernel) {
+                size_t failures = 0;
+                latency_histogram h = measure<T>(kernel, values, failures);
+                report(distribution, kernel.name, type_name, h, failures);
+            });
+        }
+    });
+
+    write_to_csv("sqrt_latency.csv", csv_data);
+
+    return EXIT_SUCCESS;
+}
+catch (const std::exception& e) {
+    std::cerr << "latency: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+}
@@ -0,0 +1,226 @@
+// Accuracy/throughput Pareto report across algorithms and types
+//
+// For each input range, every (algorithm, type) pair is timed and its error
+// measured against the correctly rounded root. A pair is dominated when
+// another pair of the same range is at least as cheap and at least as
+// accurate, and strictly better in one of the two; the rest form the
+// frontier from which to pick the cheapest kernel meeting a budget.
+// A type only sees the inputs of a range that it represents as positive
+// values, and only pairs that cover the same inputs are compared, so a type
+// whose small inputs underflow forms a frontier of its own.
+//
+//   pareto [--baseline sqrt_pareto.csv]
+//
+// With --baseline, the costs are also compared with those of an earlier
+// run, typically of a different build of the same tree: the speedup of
+// every pair and their geometric mean go to sqrt_pareto_speedup.csv.
+#include <bit>
+#include <cmath>
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <tuple>
+#include <vector>
+#include <string>
+#include <bitset>
+
+#include <mathfunction/sqrt_kernels.hpp>
+#include <mathfunction/perf_counters.hpp>
+#include <mathfunction/ulp.hpp>
+#include <mathfunction/exact_residual.hpp>
+
+// Function to write data to CSV file
+void write_to_csv(const std::string& filename, const std::vector<std::vector<std::string>>& data) {
+    std::ofstream file(filename);
+    for (const auto& row : data) {
+        for (size_t i = 0; i < row.size(); ++i) {
+            file << row[i];
+            if (i < row.size() - 1) {
+                file << ",";
+            }
+        }
+        file << "\n";
+    }
+    file.close();
+}
+
+struct pareto_point {
+    std::string algorithm;
+    std::string type_name;
+    double ns_per_op;
+    double max_ulp;
+    double mean_abs_error;
+    double correctly_rounded;
+    uint64_t coverage;
+    bool dominated = false;
+};
+
+// The inputs of a range that T represents as positive values, as a mask over their indices
+template <typename T>
+uint64_t coverage_of(const std::vector<double>& values) {
+    uint64_t mask = 0;
+    for (size_t i = 0; i < values.size(); ++i) {
+        if (T(values[i]) > T(0)) mask |= uint64_t(1) << i;
+    }
+    return mask;
+}
+
+// Cost and error statistics of one kernel on the inputs its type covers; false when there are none or it throws
+template <typename T, typename Kernel>
+bool measure(Kernel kernel, const std::vector<double>& values, pareto_point& point) {
+    std::vector<T> inputs;
+    for (size_t i = 0; i < values.size(); ++i) {
+        if (point.coverage & (uint64_t(1) << i)) inputs.push_back(T(values[i]));
+    }
+    if (inputs.empty()) return false;
+    std::vector<T> results(inputs.size());
+
+    try {
+        point.ns_per_op = best_ns_per_call([&]() {
+            for (size_t i = 0; i < inputs.size(); ++i) results[i] = kernel(inputs[i]);
+        }, inputs.size());
+    } catch (const std::exception&) {
+        return false;
+    }
+
+    double total_error = 0.0;
+    size_t exact = 0;
+    point.max_ulp = 0.0;
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        double reference = std::sqrt(static_cast<Double>(inputs[i]));
+        total_error += std::abs(static_cast<Double>(results[i]) - reference);
+        point.max_ulp = std::max(point.max_ulp, ulp_error(results[i], inputs[i]));
+        if (is_correctly_rounded_sqrt(inputs[i], results[i])) ++exact;
+    }
+    point.mean_abs_error = total_error / inputs.size();
+    point.correctly_rounded = double(exact) / inputs.size();
+    return true;
+}
+
+// Mark every point that another point on the same inputs beats on cost and mean error
+void mark_dominated(std::vector<pareto_point>& points) {
+    for (auto& p : points) {
+        for (const auto& q : points) {
+            if (q.coverage != p.coverage) continue;
+            bool no_worse = q.ns_per_op <= p.ns_per_op && q.mean_abs_error <= p.mean_abs_error;
+            bool better = q.ns_per_op < p.ns_per_op || q.mean_abs_error < p.mean_abs_error;
+            if (no_worse && better) {
+                p.dominated = true;
+                break;
+            }
+        }
+    }
+}
+
+using cost_map = std::map<std::tuple<std::string, std::string, std::string>, double>;
+
+// ns/op per (range, algorithm, type) of a report written by an earlier run
+cost_map read_costs(const std::string& filename) {
+    std::ifstream file(filename);
+    if (!file) {
+        throw std::runtime_error("cannot open baseline " + filename);
+    }
+    cost_map costs;
+    std::string line;
+    std::getline(file, line); // header
+    while (std::getline(file, line)) {
+        std::stringstream ss(line);
+        std::string range, algorithm, type_name, ns;
+        if (std::getline(ss, range, ',') && std::getline(ss, algorithm, ',') && std::getline(ss, type_name, ',') && std::getline(ss, ns, ',')) {
+            costs[{ range, algorithm, type_name }] = std::stod(ns);
+        }
+    }
+    return costs;
+}
+
+// Speedup of this run over the baseline per pair, and the geometric mean over all pairs both runs measured
+void report_speedup(const cost_map& baseline, const cost_map& costs) {
+    std::vector<std::vector<std::string>> csv_data;
+    csv_data.push_back({"Range", "Algorithm", "Type", "Baseline ns/op", "ns/op", "Speedup"});
+    double log_sum = 0.0;
+    size_t pairs = 0;
+    for (const auto& [key, ns] : costs) {
+        auto base = baseline.find(key);
+        if (base == baseline.end() || !(ns > 0.0) || !(base->second > 0.0)) continue;
+        double speedup = base->second / ns;
+        log_sum += std::log(speedup);
+        ++pairs;
+        csv_data.push_back({ std::get<0>(key), std::get<1>(key), std::get<2>(key), std::to_string(base->second), std::to_string(ns), std::to_string(speedup) });
+    }
+    double geometric_mean = (pairs > 0) ? std::exp(log_sum / pairs) : 1.0;
+    csv_data.push_back({ "all", "geometric mean", "", "", "", std::to_string(geometric_mean) });
+    write_to_csv("sqrt_pareto_speedup.csv", csv_data);
+    std::cout << std::defaultfloat << std::setprecision(3) << "Speedup over the baseline: " << geometric_mean
+              << "x geometric mean over " << pairs << " pairs" << std::endl;
+}
+
+int main(int argc, char** argv)
+try {
+    std::string baseline_file;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--baseline" && i + 1 < argc) baseline_file = argv[++i];
+        else {
+            std::cerr << "Usage: pareto [--baseline sqrt_pareto.csv]" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+    // read before this run's report overwrites a baseline of the same name
+    cost_map baseline;
+    if (!baseline_file.empty()) baseline = read_costs(baseline_file);
+
+    const std::vector<double> scale_factors = {1e-5, 1e-6, 1e-7, 1e-8, 1e-9};
+    const std::vector<std::string> ranges = {"range1", "range2", "range3", "range4", "range5"};
+    const int bitset_size = 16; // Number of bits to iterate over
+    std::cout << std::scientific << std::setprecision(3);
+
+    cost_map costs;
+    std::vector<std::vector<std::string>> csv_data;
+    csv_data.push_back({"Range", "Algorithm", "Type", "ns/op", "Max ULP", "Mean Abs Error", "Correctly Rounded", "Pareto", "Inputs"});
+
+    static_assert(bitset_size <= 64, "coverage masks hold one bit per input");
+    for (size_t r = 0; r < scale_factors.size(); ++r) {
+        std::vector<double> values;
+        for (int i = 0; i < bitset_size; ++i) {
+            values.push_back(static_cast<double>(std::bitset<bitset_size>(1 << i).to_ulong()) * scale_factors[r]);
+        }
+
+        std::vector<pareto_point> points;
+        for_each_type([&](auto type) {
+            using T = typename decltype(type)::type;
+            const uint64_t coverage = coverage_of<T>(values);
+            for_each_kernel([&](auto kernel) {
+                pareto_point point{ kernel.name, number_type_name<T>::value, 0, 0, 0, 0, coverage };
+                if (measure<T>(kernel, values, point)) points.push_back(point);
+            });
+        });
+        mark_dominated(points);
+
+        std::cout << ranges[r] << " (scale " << scale_factors[r] << ") frontier:" << std::endl;
+        for (const auto& p : points) {
+            const std::string inputs = std::to_string(std::popcount(p.coverage)) + "/" + std::to_string(values.size());
+            if (!p.dominated) {
+                std::cout << std::setw(14) << p.algorithm << std::setw(10) << p.type_name
+                          << ": " << p.ns_per_op << " ns/op, Mean Abs Error: " << p.mean_abs_error
+                          << ", Max ULP: " << p.max_ulp << ", Correctly Rounded: " << p.correctly_rounded
+                          << ", Inputs: " << inputs << std::endl;
+            }
+            costs[{ ranges[r], p.algorithm, p.type_name }] = p.ns_per_op;
+            csv_data.push_back({ ranges[r], p.algorithm, p.type_name, std::to_string(p.ns_per_op), std::to_string(p.max_ulp),
+                                 std::to_string(p.mean_abs_error), std::to_string(p.correctly_rounded),
+                                 p.dominated ? "dominated" : "frontier", inputs });
+        }
+    }
+
+    write_to_csv("sqrt_pareto.csv", csv_data);
+    if (!baseline_file.empty()) report_speedup(baseline, costs);
+
+    return EXIT_SUCCESS;
+}
+catch (const std::exception& e) {
+    std::cerr << "pareto: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+}
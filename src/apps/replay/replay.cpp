@@ -0,0 +1,204 @@
+// Trace replay: run the sqrt kernels over a captured binary input file
+//
+//   replay --trace <file> [--format double|Posit16|Posit32|Fixpnt16|Float|Double]
+//          [--algorithms basic,poly,...] [--types Posit16,Double,...]
+//          [--chunk 1048576] [--output-dir <directory>]
+//
+// A double trace holds IEEE binary64 values and is converted to every selected
+// type; a trace in one of the type formats holds raw encodings of that type
+// and replays only that type. The trace is memory-mapped with a sequential
+// access hint and cut into chunks that worker threads take in order;
+// every selected (algorithm, type) pair runs over a chunk while it is resident,
+// after which its pages are released. With --output-dir every pair writes
+// the encodings of its results to a mapped file of the trace's length.
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <functional>
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <sstream>
+#include <vector>
+#include <string>
+
+#include <mathfunction/sqrt_algorithm.hpp>
+#include <mathfunction/reduction.hpp>
+#include <mathfunction/mapped_file.hpp>
+#include <mathfunction/error_stats.hpp>
+#include <mathfunction/ulp.hpp>
+
+// Function to write data to CSV file
+void write_to_csv(const std::string& filename, const std::vector<std::vector<std::string>>& data) {
+    std::ofstream file(filename);
+    for (const auto& row : data) {
+        for (size_t i = 0; i < row.size(); ++i) {
+            file << row[i];
+            if (i < row.size() - 1) {
+                file << ",";
+            }
+        }
+        file << "\n";
+    }
+    file.close();
+}
+
+std::vector<std::string> split(const std::string& list) {
+    std::vector<std::string> items;
+    std::stringstream ss(list);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (!item.empty()) items.push_back(item);
+    }
+    return items;
+}
+
+struct replay_options {
+    std::string trace;
+    std::string format = "double";
+    std::vector<std::string> algorithms = { "basic", "heron", "bakhshali", "cordic", "exp", "poly", "goldschmidt" };
+    std::vector<std::string> types = { "Posit16", "Posit32", "Fixpnt16", "Float", "Double" };
+    size_t chunk = size_t(1) << 20;
+    std::string output_dir;
+};
+
+// One (algorithm, type) pair: runs over [first, last) of the trace into its stats and output
+struct replay_pair {
+    std::string algorithm;
+    std::string type_name;
+    std::function<void(size_t, size_t, error_stats&)> run;
+    mapped_file output;
+};
+
+template <typename T>
+void add_pairs(const replay_options& options, const mapped_file& trace, size_t n, std::vector<std::unique_ptr<replay_pair>>& pairs) {
+    const std::string type_name = number_type_name<T>::value;
+    const bool raw = (options.format == type_name);
+    if (!raw && options.format != "double") return;
+    if (std::find(options.types.begin(), options.types.end(), type_name) == options.types.end()) return;
+
+    for (const auto& name : options.algorithms) {
+        auto pair = std::make_unique<replay_pair>();
+        pair->algorithm = name;
+        pair->type_name = type_name;
+        if (!options.output_dir.empty()) {
+            pair->output = mapped_file::create(options.output_dir + "/" + name + "_" + type_name + ".bin", n * sizeof(encoding_word_t<T>));
+        }
+        sqrt_algorithm algorithm = parse_sqrt_algorithm(name);
+        replay_pair* p = pair.get();
+        p->run = [&trace, raw, algorithm, p](size_t first, size_t last, error_stats& stats) {
+            auto* out = static_cast<encoding_word_t<T>*>(p->output.data());
+            for (size_t i = first; i < last; ++i) {
+                T x;
+                if (raw) {
+                    x = decode<T>(static_cast<const encoding_word_t<T>*>(trace.data())[i]);
+                } else {
+                    x = T(static_cast<const double*>(trace.data())[i]);
+                }
+                T y(0);
+                if (!(x > T(0))) {
+                    ++stats.skipped;
+                } else {
+                    try {
+                        y = sqrt_with(algorithm, x);
+                        double ulp = ulp_error(y, x);
+                        stats.add(std::isnan(ulp) ? INFINITY : ulp, static_cast<double>(x));
+                    } catch (const std::exception&) {
+                        ++stats.failures;
+                    }
+                }
+                if (out != nullptr) out[i] = encode(y);
+            }
+        };
+        pairs.push_back(std::move(pair));
+    }
+}
+
+int main(int argc, char** argv)
+try {
+    replay_options options;
+    bool usage = false;
+    for (int i = 1; i < argc && !usage; i += 2) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) usage = true;
+        else if (arg == "--trace") options.trace = argv[i + 1];
+        else if (arg == "--format") options.format = argv[i + 1];
+        else if (arg == "--algorithms") options.algorithms = split(argv[i + 1]);
+        else if (arg == "--types") options.types = split(argv[i + 1]);
+        else if (arg == "--chunk") options.chunk = std::max<size_t>(1, std::stoul(argv[i + 1]));
+        else if (arg == "--output-dir") options.output_dir = argv[i + 1];
+        else usage = true;
+    }
+    if (usage || options.trace.empty()) {
+        std::cerr << "Usage: replay --trace file [--format double|<type>] [--algorithms a,b] [--types T,U] [--chunk n] [--output-dir dir]" << std::endl;
+        return EXIT_FAILURE;
+    }
+    if (!options.output_dir.empty()) std::filesystem::create_directories(options.output_dir);
+
+    mapped_file trace = mapped_file::open_read(options.trace);
+    trace.advise(MADV_SEQUENTIAL);
+    size_t element_size = sizeof(double);
+    if (options.format != "double") {
+        int type = -1, index = 0;
+        for_each_type([&](auto t) {
+            using T = typename decltype(t)::type;
+            if (options.format == number_type_name<T>::value) { type = index; element_size = sizeof(encoding_word_t<T>); }
+            ++index;
+        });
+        if (type < 0) throw std::runtime_error("unknown trace format " + options.format);
+    }
+    if (trace.size() % element_size != 0) {
+        throw std::runtime_error("trace size is not a multiple of the " + options.format + " encoding");
+    }
+    const size_t n = trace.size() / element_size;
+
+    std::vector<std::unique_ptr<replay_pair>> pairs;
+    for_each_type([&](auto t) {
+        using T = typename decltype(t)::type;
+        add_pairs<T>(options, trace, n, pairs);
+    });
+    if (pairs.empty()) throw std::runtime_error("no (algorithm, type) pair selected for a " + options.format + " trace");
+
+    // one error_stats per pair and chunk, combined in a fixed tree: the report does not depend on the thread count
+    const size_t chunks = (n + options.chunk - 1) / options.chunk;
+    std::vector<error_stats> totals = parallel_reduce(n, options.chunk, std::vector<error_stats>(pairs.size()),
+        [&](size_t first, size_t last, std::vector<error_stats>& partial) {
+            trace.advise(MADV_WILLNEED, first * element_size, (last - first) * element_size);
+            for (size_t p = 0; p < pairs.size(); ++p) pairs[p]->run(first, last, partial[p]);
+            // the trace is read once: drop the chunk instead of letting it crowd the page cache
+            trace.advise(MADV_DONTNEED, first * element_size, (last - first) * element_size);
+        },
+        [](std::vector<error_stats>& lhs, const std::vector<error_stats>& rhs) {
+            for (size_t p = 0; p < lhs.size(); ++p) lhs[p].merge(rhs[p]);
+        });
+
+    std::vector<std::vector<std::string>> csv_data, histogram_data;
+    csv_data.push_back({"Algorithm", "Type", "Inputs", "Skipped", "Failures", "Max ULP", "Max ULP Argument", "Mean ULP", "ULP Std Dev",
+                        "ULP p50", "ULP p99", "ULP p99.9"});
+    histogram_data.push_back({"Algorithm", "Type"});
+    for (size_t b = 0; b < ulp_histogram::bucket_count; ++b) histogram_data.back().push_back("<=" + std::to_string(ulp_histogram::bucket_upper(b)));
+    std::cout << n << " inputs from " << options.trace << " (" << options.format << "), " << chunks << " chunks" << std::endl;
+    std::cout << std::scientific << std::setprecision(3);
+    for (size_t i = 0; i < pairs.size(); ++i) {
+        const replay_pair* p = pairs[i].get();
+        const error_stats& stats = totals[i];
+        std::cout << std::setw(14) << p->algorithm << std::setw(10) << p->type_name << ": Max ULP: " << stats.max_ulp
+                  << " at " << stats.max_ulp_argument << ", Mean ULP: " << stats.mean << ", Std Dev: " << std::sqrt(stats.variance())
+                  << ", p99 ULP: " << stats.quantile(0.99) << ", Skipped: " << stats.skipped << ", Failures: " << stats.failures << std::endl;
+        csv_data.push_back({ p->algorithm, p->type_name, std::to_string(stats.count), std::to_string(stats.skipped), std::to_string(stats.failures),
+                             std::to_string(stats.max_ulp), argument_text(stats.max_ulp_argument), std::to_string(stats.mean),
+                             std::to_string(std::sqrt(stats.variance())), std::to_string(stats.quantile(0.5)),
+                             std::to_string(stats.quantile(0.99)), std::to_string(stats.quantile(0.999)) });
+        histogram_data.push_back({ p->algorithm, p->type_name });
+        for (size_t b = 0; b < ulp_histogram::bucket_count; ++b) histogram_data.back().push_back(std::to_string(stats.histogram.count(b)));
+    }
+    write_to_csv("sqrt_replay.csv", csv_data);
+    write_to_csv("sqrt_replay_histogram.csv", histogram_data);
+
+    return EXIT_SUCCESS;
+}
+catch (const std::exception& e) {
+    std::cerr << "replay: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+}
@@ -0,0 +1,279 @@
+// Result diff: which inputs changed result between two sweep runs, and by how many ULPs
+//
+//   resultdiff <lhs> <rhs> --type Posit16|Posit32|Fixpnt16|Float|Double
+//              [--first 20] [--threads n] [--trace file [--trace-format double|<type>]]
+//
+// A result set is one of
+//   .bin  raw result encodings, one per trace position, as written by replay --output-dir
+//   .seg  a result cache segment: (input, output) entries sorted by input encoding
+//   .csv  rows of input,output; a field written 0x... is a raw encoding,
+//         anything else a number converted to the type; other lines are skipped
+// Two .bin files are compared position by position, mapped and never copied;
+// segments and CSV files are joined on the input encoding. The ULP distance
+// of two results is the number of values of the type between them. The
+// counts go to stdout with the first differences, the ULP histogram of the
+// changed results to sqrt_diff_histogram.csv and the first differences to
+// sqrt_diff.csv. --trace labels the positions of .bin files with the inputs
+// of the replayed trace. Like diff(1), the exit status is 0 when the result
+// sets agree, 1 when they differ and 2 on errors.
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <filesystem>
+#include <functional>
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <vector>
+#include <string>
+
+#include <mathfunction/sqrt_kernels.hpp>
+#include <mathfunction/result_diff.hpp>
+
+// exit status, as diff(1) has it
+constexpr int diff_same = 0;
+constexpr int diff_different = 1;
+constexpr int diff_trouble = 2;
+
+// Function to write data to CSV file
+void write_to_csv(const std::string& filename, const std::vector<std::vector<std::string>>& data) {
+    std::ofstream file(filename);
+    for (const auto& row : data) {
+        for (size_t i = 0; i < row.size(); ++i) {
+            file << row[i];
+            if (i < row.size() - 1) {
+                file << ",";
+            }
+        }
+        file << "\n";
+    }
+    file.close();
+}
+
+struct diff_options {
+    std::string lhs;
+    std::string rhs;
+    std::string type;
+    size_t first = 20;
+    unsigned threads = 0;
+    std::string trace;
+    std::string trace_format = "double";
+};
+
+std::string extension(const std::string& path) {
+    return std::filesystem::path(path).extension().string();
+}
+
+// Encoding of T from a CSV field; false when the field is not a number
+template <typename T>
+bool parse_field(const char* first, const char* last, uint64_t& bits) {
+    while (first < last && (*first == ' ' || *first == '\t')) ++first;
+    while (last > first && (last[-1] == ' ' || last[-1] == '\t' || last[-1] == '\r')) --last;
+    if (last - first > 2 && first[0] == '0' && (first[1] == 'x' || first[1] == 'X')) {
+        auto [end, error] = std::from_chars(first + 2, last, bits, 16);
+        return error == std::errc() && end == last;
+    }
+    double value;
+    auto [end, error] = std::from_chars(first, last, value);
+    if (error != std::errc() || end != last) return false;
+    bits = encode(T(value));
+    return true;
+}
+
+// Entries of the input,output rows of [first, last)
+template <typename T>
+void parse_rows(const char* first, const char* last, std::vector<cache_entry>& entries) {
+    while (first < last) {
+        const char* eol = std::find(first, last, '\n');
+        const char* comma = std::find(first, eol, ',');
+        const char* end = std::find(comma == eol ? eol : comma + 1, eol, ',');
+        cache_entry e{ 0, 0, 0, 0 };
+        if (comma != eol && parse_field<T>(first, comma, e.input) && parse_field<T>(comma + 1, end, e.output)) entries.push_back(e);
+        first = (eol == last) ? last : eol + 1;
+    }
+}
+
+// A CSV result set as cache entries sorted by input; the file is cut at line
+// boundaries into pieces parsed in parallel and concatenated in order
+template <typename T>
+std::vector<cache_entry> read_csv(const std::string& path, unsigned threads) {
+    mapped_file file = mapped_file::open_read(path);
+    file.advise(MADV_SEQUENTIAL);
+    const char* text = static_cast<const char*>(file.data());
+    const size_t size = file.size();
+    const size_t piece = size_t(1) << 24;
+    const size_t pieces = (size + piece - 1) / piece;
+    // a piece starts after the first line break at or past its nominal start
+    auto start = [&](size_t p) {
+        if (p == 0) return size_t(0);
+        if (p >= pieces) return size;
+        const char* eol = std::find(text + p * piece - 1, text + size, '\n');
+        return (eol == text + size) ? size : static_cast<size_t>(eol - text) + 1;
+    };
+    std::vector<std::vector<cache_entry>> parsed(pieces);
+    for_each_block(pieces, 1, [&](size_t p, size_t, size_t) {
+        size_t first = start(p), last = start(p + 1);
+        if (first < last) parse_rows<T>(text + first, text + last, parsed[p]);
+    }, threads);
+
+    std::vector<cache_entry> entries;
+    for (const auto& rows : parsed) entries.insert(entries.end(), rows.begin(), rows.end());
+    if (!std::is_sorted(entries.begin(), entries.end(), [](const cache_entry& a, const cache_entry& b) { return a.input < b.input; })) {
+        std::stable_sort(entries.begin(), entries.end(), [](const cache_entry& a, const cache_entry& b) { return a.input < b.input; });
+    }
+    return entries;
+}
+
+// The entries of a segment or CSV result set, in the storage that keeps them alive
+struct entry_set {
+    mapped_segment segment{ "" };
+    std::vector<cache_entry> rows;
+    const cache_entry* data = nullptr;
+    size_t size = 0;
+};
+
+template <typename T>
+void load_entries(const std::string& path, unsigned threads, entry_set& set) {
+    if (extension(path) == ".csv") {
+        set.rows = read_csv<T>(path, threads);
+        set.data = set.rows.data();
+        set.size = set.rows.size();
+    } else {
+        set.segment = mapped_segment(path);
+        if (set.segment.begin() == nullptr && std::filesystem::file_size(path) > 0) throw std::runtime_error(path + " is not a result cache segment");
+        set.data = set.segment.begin();
+        set.size = static_cast<size_t>(set.segment.end() - set.segment.begin());
+    }
+}
+
+template <typename T>
+std::string value_of(uint64_t bits) {
+    std::stringstream ss;
+    ss << std::setprecision(std::numeric_limits<double>::max_digits10) << static_cast<double>(decode<T>(static_cast<encoding_word_t<T>>(bits)));
+    return ss.str();
+}
+
+template <typename T>
+std::string hex_of(uint64_t bits) {
+    std::stringstream ss;
+    ss << "0x" << std::hex << std::setw(encoding_bits<T>() / 4) << std::setfill('0') << bits;
+    return ss.str();
+}
+
+template <typename T>
+int run_diff(const diff_options& options) {
+    const std::string type_name = number_type_name<T>::value;
+    using word = encoding_word_t<T>;
+    const bool positional = extension(options.lhs) == ".bin";
+    if (positional != (extension(options.rhs) == ".bin")) {
+        throw std::runtime_error("a .bin result set can only be compared with another .bin result set");
+    }
+
+    result_diff diff;
+    std::function<std::string(const result_difference&)> input_label = [](const result_difference& d) { return value_of<T>(d.input); };
+    mapped_file trace;
+    if (positional) {
+        mapped_file lhs = mapped_file::open_read(options.lhs), rhs = mapped_file::open_read(options.rhs);
+        if (lhs.size() % sizeof(word) != 0 || rhs.size() % sizeof(word) != 0) {
+            throw std::runtime_error("result sizes are not a multiple of the " + type_name + " encoding");
+        }
+        size_t nl = lhs.size() / sizeof(word), nr = rhs.size() / sizeof(word);
+        lhs.advise(MADV_SEQUENTIAL);
+        rhs.advise(MADV_SEQUENTIAL);
+        diff = diff_results<T>(static_cast<const word*>(lhs.data()), static_cast<const word*>(rhs.data()), std::min(nl, nr), options.first, options.threads);
+        diff.only_lhs = nl - std::min(nl, nr);
+        diff.only_rhs = nr - std::min(nl, nr);
+
+        // a position is an index into the replayed trace
+        input_label = [](const result_difference& d) { return "#" + std::to_string(d.position); };
+        if (!options.trace.empty()) {
+            trace = mapped_file::open_read(options.trace);
+            std::string format = options.trace_format;
+            input_label = [&trace, format](const result_difference& d) {
+                std::string label = "#" + std::to_string(d.position);
+                if (format == "double") {
+                    if ((d.position + 1) * sizeof(double) <= trace.size()) {
+                        std::stringstream ss;
+                        ss << std::setprecision(std::numeric_limits<double>::max_digits10) << static_cast<const double*>(trace.data())[d.position];
+                        label = ss.str();
+                    }
+                } else if ((d.position + 1) * sizeof(word) <= trace.size()) {
+                    label = value_of<T>(static_cast<const word*>(trace.data())[d.position]);
+                }
+                return label;
+            };
+        }
+    } else {
+        entry_set lhs, rhs;
+        load_entries<T>(options.lhs, options.threads, lhs);
+        load_entries<T>(options.rhs, options.threads, rhs);
+        diff = diff_results<T>(lhs.data, lhs.size, rhs.data, rhs.size, options.first, options.threads);
+    }
+
+    auto ulps_of = [](const result_difference& d) { return d.ulps == diff_failed_ulps ? std::string("failed") : std::to_string(d.ulps); };
+    std::cout << type_name << ": " << diff.compared << " compared, " << diff.changed << " changed";
+    if (diff.compared > 0) std::cout << " (" << std::setprecision(4) << 100.0 * double(diff.changed) / double(diff.compared) << "%)";
+    std::cout << ", " << diff.only_lhs << " only in " << options.lhs << ", " << diff.only_rhs << " only in " << options.rhs << std::endl;
+    if (diff.changed > 0) {
+        std::cout << "Largest change: " << ulps_of(diff.largest) << " ULPs at " << input_label(diff.largest) << std::endl;
+        std::cout << "ULP change histogram:" << std::endl;
+        for (size_t b = 0; b < ulp_histogram::bucket_count; ++b) {
+            if (diff.histogram.count(b) == 0) continue;
+            std::cout << "  <= " << std::setw(12) << ulp_histogram::bucket_upper(b) << ": " << diff.histogram.count(b) << std::endl;
+        }
+        std::cout << "First " << diff.first.size() << " changes:" << std::endl;
+    }
+
+    std::vector<std::vector<std::string>> csv_data, histogram_data;
+    csv_data.push_back({"Position", "Input", "Left", "Right", "Left Encoding", "Right Encoding", "ULPs"});
+    for (const auto& d : diff.first) {
+        std::cout << std::setw(24) << input_label(d) << ": " << std::setw(24) << value_of<T>(d.lhs) << " -> " << std::setw(24) << value_of<T>(d.rhs)
+                  << "  (" << hex_of<T>(d.lhs) << " -> " << hex_of<T>(d.rhs) << ", " << ulps_of(d) << " ULPs)" << std::endl;
+        csv_data.push_back({ std::to_string(d.position), input_label(d), value_of<T>(d.lhs), value_of<T>(d.rhs), hex_of<T>(d.lhs), hex_of<T>(d.rhs), ulps_of(d) });
+    }
+    histogram_data.push_back({"ULPs At Most", "Changed Results"});
+    for (size_t b = 0; b < ulp_histogram::bucket_count; ++b) {
+        histogram_data.push_back({ std::to_string(ulp_histogram::bucket_upper(b)), std::to_string(diff.histogram.count(b)) });
+    }
+    write_to_csv("sqrt_diff.csv", csv_data);
+    write_to_csv("sqrt_diff_histogram.csv", histogram_data);
+
+    return (diff.changed == 0 && diff.only_lhs == 0 && diff.only_rhs == 0) ? diff_same : diff_different;
+}
+
+int main(int argc, char** argv)
+try {
+    diff_options options;
+    std::vector<std::string> files;
+    bool usage = false;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--type" && i + 1 < argc) options.type = argv[++i];
+        else if (arg == "--first" && i + 1 < argc) options.first = std::stoul(argv[++i]);
+        else if (arg == "--threads" && i + 1 < argc) options.threads = static_cast<unsigned>(std::stoul(argv[++i]));
+        else if (arg == "--trace" && i + 1 < argc) options.trace = argv[++i];
+        else if (arg == "--trace-format" && i + 1 < argc) options.trace_format = argv[++i];
+        else if (arg.rfind("--", 0) == 0) usage = true;
+        else files.push_back(arg);
+    }
+    if (usage || files.size() != 2 || options.type.empty()) {
+        std::cerr << "Usage: resultdiff lhs rhs --type <type> [--first n] [--threads n] [--trace file [--trace-format double|<type>]]" << std::endl;
+        return diff_trouble;
+    }
+    options.lhs = files[0];
+    options.rhs = files[1];
+
+    int status = -1;
+    for_each_type([&](auto t) {
+        using T = typename decltype(t)::type;
+        if (options.type == number_type_name<T>::value) status = run_diff<T>(options);
+    });
+    if (status < 0) throw std::runtime_error("unknown type " + options.type);
+    return status;
+}
+catch (const std::exception& e) {
+    std::cerr << "resultdiff: " << e.what() << std::endl;
+    return diff_trouble;
+}
@@ -0,0 +1,189 @@
+// sqrt_client: load generator for sqrt_server, reports throughput and latency
+//
+//   sqrt_client [--socket /tmp/mathfunction-sqrt.sock] [--clients 4] [--requests 1000]
+//               [--count 64] [--type Posit32] [--algorithm goldschmidt] [--shm-threshold bytes]
+//
+// Every client thread keeps one connection and sends its requests back to
+// back. Payloads of at least shm-threshold bytes go through a shared memory
+// object instead of the socket. The first response of every client is
+// checked against the same kernel run locally.
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <mathfunction/sqrt_service.hpp>
+#include <mathfunction/latency_histogram.hpp>
+
+struct load_options {
+    std::string path = sqrt_service_default_socket;
+    int clients = 4;
+    size_t requests = 1000;
+    size_t count = 64;
+    int type = 1;
+    sqrt_algorithm algorithm = sqrt_algorithm::goldschmidt;
+    size_t shm_threshold = sqrt_service_shm_threshold;
+};
+
+int connect_to(const std::string& path) {
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+    if (fd < 0 || connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+        throw std::runtime_error("connect " + path + ": " + strerror(errno));
+    }
+    return fd;
+}
+
+// Raw encodings of log-uniform values in [1e-3, 1e3] of sweep type index type
+std::vector<uint8_t> make_inputs(int type, size_t count, uint64_t seed) {
+    std::vector<uint8_t> bytes(count * sqrt_service_encoding_size(type));
+    std::mt19937_64 rng(seed);
+    std::uniform_real_distribution<double> exponent(std::log2(1e-3), std::log2(1e3));
+    int index = 0;
+    for_each_type([&](auto t) {
+        using T = typename decltype(t)::type;
+        using word = encoding_word_t<T>;
+        if (index++ != type) return;
+        auto* out = reinterpret_cast<word*>(bytes.data());
+        for (size_t i = 0; i < count; ++i) out[i] = encode(T(std::exp2(exponent(rng))));
+    });
+    return bytes;
+}
+
+struct client_result {
+    latency_histogram latency;
+    uint64_t errors = 0;
+    uint64_t mismatches = 0;
+};
+
+void run_client(const load_options& options, int id, client_result& result) {
+    const size_t bytes = options.count * sqrt_service_encoding_size(options.type);
+    const bool shared = bytes >= options.shm_threshold && bytes > 0;
+    std::vector<uint8_t> input = make_inputs(options.type, options.count, 0x5eed + id);
+    std::vector<uint8_t> output(bytes), expected(bytes);
+    sqrt_service_run(options.type, options.algorithm, input.data(), expected.data(), options.count);
+
+    sqrt_service_request header{};
+    header.magic = sqrt_service_magic;
+    header.type = static_cast<uint8_t>(options.type);
+    header.algorithm = static_cast<uint8_t>(options.algorithm);
+    header.count = options.count;
+
+    // shared payloads: inputs written once, results read in place
+    uint8_t* base = nullptr;
+    if (shared) {
+        std::snprintf(header.shm_name, sizeof(header.shm_name), "/mathfunction-sqrt-%d-%d", static_cast<int>(getpid()), id);
+        int fd = shm_open(header.shm_name, O_CREAT | O_RDWR | O_TRUNC, 0600);
+        if (fd < 0 || ftruncate(fd, static_cast<off_t>(2 * bytes)) < 0) throw std::runtime_error("shm_open: " + std::string(strerror(errno)));
+        base = static_cast<uint8_t*>(mmap(nullptr, 2 * bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0));
+        close(fd);
+        if (base == MAP_FAILED) throw std::runtime_error("mmap: " + std::string(strerror(errno)));
+        std::memcpy(base, input.data(), bytes);
+        header.shared = 1;
+    }
+
+    int fd = connect_to(options.path);
+    for (size_t r = 0; r < options.requests; ++r) {
+        auto start = std::chrono::steady_clock::now();
+        sqrt_service_response response;
+        bool ok = write_all(fd, &header, sizeof(header))
+            && (shared || write_all(fd, input.data(), bytes))
+            && read_all(fd, &response, sizeof(response))
+            && (shared || response.status == EINVAL || read_all(fd, output.data(), bytes));
+        auto stop = std::chrono::steady_clock::now();
+        if (!ok) throw std::runtime_error("connection to sqrt_server lost");
+        result.latency.record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count()));
+        if (response.status != 0) ++result.errors;
+        if (r == 0) {
+            const uint8_t* results = shared ? base + bytes : output.data();
+            if (std::memcmp(results, expected.data(), bytes) != 0) ++result.mismatches;
+        }
+    }
+    close(fd);
+
+    if (shared) {
+        munmap(base, 2 * bytes);
+        shm_unlink(header.shm_name);
+    }
+}
+
+int main(int argc, char** argv)
+try {
+    load_options options;
+    bool usage = false;
+    for (int i = 1; i < argc && !usage; i += 2) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) usage = true;
+        else if (arg == "--socket") options.path = argv[i + 1];
+        else if (arg == "--clients") options.clients = std::stoi(argv[i + 1]);
+        else if (arg == "--requests") options.requests = std::stoul(argv[i + 1]);
+        else if (arg == "--count") options.count = std::stoul(argv[i + 1]);
+        else if (arg == "--type") options.type = parse_sqrt_service_type(argv[i + 1]);
+        else if (arg == "--algorithm") options.algorithm = parse_sqrt_algorithm(argv[i + 1]);
+        else if (arg == "--shm-threshold") options.shm_threshold = std::stoul(argv[i + 1]);
+        else usage = true;
+    }
+    if (usage) {
+        std::cerr << "Usage: sqrt_client [--socket path] [--clients n] [--requests n] [--count n] [--type name] [--algorithm name] [--shm-threshold bytes]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::vector<client_result> results(options.clients);
+    std::vector<std::thread> threads;
+    std::mutex failure_mutex;
+    std::string failure;
+    auto start = std::chrono::steady_clock::now();
+    for (int c = 0; c < options.clients; ++c) {
+        threads.emplace_back([&, c]() {
+            try {
+                run_client(options, c, results[c]);
+            } catch (const std::exception& e) {
+                std::lock_guard<std::mutex> lock(failure_mutex);
+                failure = e.what();
+            }
+        });
+    }
+    for (auto& th : threads) {
+        if (th.joinable()) {
+            th.join();
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (!failure.empty()) throw std::runtime_error(failure);
+
+    latency_histogram latency;
+    uint64_t errors = 0, mismatches = 0;
+    for (const auto& r : results) {
+        latency.merge(r.latency);
+        errors += r.errors;
+        mismatches += r.mismatches;
+    }
+    double requests = static_cast<double>(latency.count());
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << options.clients << " clients x " << options.requests << " requests of " << options.count << " "
+              << sqrt_service_type_name(options.type) << " (" << sqrt_algorithm_name(options.algorithm) << ")" << std::endl;
+    std::cout << "throughput: " << requests / seconds << " requests/s, " << requests * options.count / seconds << " roots/s" << std::endl;
+    std::cout << "latency us: p50 " << latency.percentile(0.50) / 1e3 << ", p90 " << latency.percentile(0.90) / 1e3
+              << ", p99 " << latency.percentile(0.99) / 1e3 << ", max " << latency.max() / 1e3 << std::endl;
+    std::cout << "errors: " << errors << ", mismatches against the local kernel: " << mismatches << std::endl;
+
+    return (mismatches == 0 ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+catch (const std::exception& e) {
+    std::cerr << "sqrt_client: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+}
@@ -0,0 +1,212 @@
+// sqrt_server: long-lived local sqrt service on a Unix domain socket
+//
+//   sqrt_server [--socket /tmp/mathfunction-sqrt.sock] [--window-us 200]
+//
+// Every connection gets a reader thread that queues its requests. One batcher
+// collects the queue for a short window after the first request arrives,
+// concatenates the inline payloads that share a type and algorithm into one
+// batch, and runs it through the blocked, multi-threaded encoded kernels.
+// Only the requests holding a rejected input are answered with EDOM.
+// Shared memory payloads are computed in place, one request at a time.
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <cstring>
+#include <future>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <mathfunction/sqrt_service.hpp>
+
+struct pending_request {
+    sqrt_service_request header;
+    std::vector<uint8_t> input;    // inline payloads
+    std::vector<uint8_t> output;
+    std::promise<int> status;
+};
+
+class request_batcher {
+public:
+    explicit request_batcher(std::chrono::microseconds window) : window(window) {}
+
+    std::future<int> submit(pending_request* request) {
+        std::future<int> result = request->status.get_future();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            queue.push_back(request);
+        }
+        ready.notify_one();
+        return result;
+    }
+
+    void run() {
+        for (;;) {
+            std::vector<pending_request*> batch;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                ready.wait(lock, [&]() { return !queue.empty(); });
+                // let concurrent clients join the batch
+                lock.unlock();
+                std::this_thread::sleep_for(window);
+                lock.lock();
+                batch.swap(queue);
+            }
+            process(batch);
+        }
+    }
+
+private:
+    void process(std::vector<pending_request*>& batch) {
+        std::map<std::pair<int, int>, std::vector<pending_request*>> groups;
+        for (pending_request* r : batch) {
+            if (r->header.shared) {
+                r->status.set_value(run_shared(r->header));
+            } else {
+                groups[{ r->header.type, r->header.algorithm }].push_back(r);
+            }
+        }
+        for (auto& [key, members] : groups) {
+            size_t bytes = 0;
+            for (pending_request* r : members) bytes += r->input.size();
+            std::vector<uint8_t> input, output(bytes);
+            input.reserve(bytes);
+            for (pending_request* r : members) input.insert(input.end(), r->input.begin(), r->input.end());
+
+            const size_t size = sqrt_service_encoding_size(key.first);
+            const sqrt_algorithm algorithm = static_cast<sqrt_algorithm>(key.second);
+            int status = sqrt_service_run(key.first, algorithm, input.data(), output.data(), bytes / size);
+
+            // a rejected input is answered to its own client only: when the
+            // batch failed, each request is run again on its own for its status
+            size_t offset = 0;
+            for (pending_request* r : members) {
+                r->output.assign(output.begin() + offset, output.begin() + offset + r->input.size());
+                offset += r->input.size();
+                int own = status;
+                if (status != 0 && members.size() > 1) {
+                    own = sqrt_service_run(key.first, algorithm, r->input.data(), r->output.data(), r->input.size() / size);
+                }
+                r->status.set_value(own);
+            }
+        }
+    }
+
+    static int run_shared(const sqrt_service_request& header) {
+        std::string name(header.shm_name, strnlen(header.shm_name, sizeof(header.shm_name)));
+        int fd = shm_open(name.c_str(), O_RDWR, 0);
+        if (fd < 0) return EINVAL;
+        // inputs and results both have to fit in the object
+        struct stat info;
+        size_t bytes = 0;
+        if (fstat(fd, &info) < 0 || !sqrt_service_payload_bytes(header, static_cast<size_t>(info.st_size) / 2, bytes) || bytes == 0) {
+            close(fd);
+            return EINVAL;
+        }
+        void* base = mmap(nullptr, 2 * bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (base == MAP_FAILED) return EINVAL;
+        int status = sqrt_service_run(header.type, static_cast<sqrt_algorithm>(header.algorithm), base, static_cast<uint8_t*>(base) + bytes, header.count);
+        munmap(base, 2 * bytes);
+        return status;
+    }
+
+    std::chrono::microseconds window;
+    std::mutex mutex;
+    std::condition_variable ready;
+    std::vector<pending_request*> queue;
+};
+
+// A well-formed request; bytes receives the size of an inline payload
+bool valid(const sqrt_service_request& header, size_t& bytes) {
+    return header.magic == sqrt_service_magic
+        && header.type < sqrt_service_type_count
+        && header.algorithm < sqrt_algorithm_count
+        && (header.shared || sqrt_service_payload_bytes(header, sqrt_service_inline_limit, bytes));
+}
+
+// Serve one client until it disconnects
+void serve(int client, request_batcher& batcher) {
+    sqrt_service_request header;
+    while (read_all(client, &header, sizeof(header))) {
+        sqrt_service_response response{ sqrt_service_magic, 0, header.count };
+        size_t bytes = 0;
+        if (!valid(header, bytes)) {
+            response.status = EINVAL;
+            response.count = 0;
+            if (!write_all(client, &response, sizeof(response))) break;
+            continue;
+        }
+
+        pending_request request;
+        request.header = header;
+        if (!header.shared) {
+            request.input.resize(bytes);
+            if (!read_all(client, request.input.data(), request.input.size())) break;
+        }
+        response.status = batcher.submit(&request).get();
+
+        if (!write_all(client, &response, sizeof(response))) break;
+        if (!header.shared && !write_all(client, request.output.data(), request.output.size())) break;
+    }
+    close(client);
+}
+
+int main(int argc, char** argv)
+try {
+    std::string path = sqrt_service_default_socket;
+    long window_us = 200;
+    bool usage = false;
+    for (int i = 1; i < argc && !usage; i += 2) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) usage = true;
+        else if (arg == "--socket") path = argv[i + 1];
+        else if (arg == "--window-us") window_us = std::stol(argv[i + 1]);
+        else usage = true;
+    }
+    if (usage) {
+        std::cerr << "Usage: sqrt_server [--socket path] [--window-us microseconds]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0) throw std::runtime_error("socket: " + std::string(strerror(errno)));
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path)) throw std::runtime_error("socket path too long: " + path);
+    std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+    unlink(path.c_str());
+    if (bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 || listen(listener, 128) < 0) {
+        throw std::runtime_error("bind " + path + ": " + strerror(errno));
+    }
+    std::signal(SIGPIPE, SIG_IGN);
+    std::cout << "sqrt_server listening on " << path << ", batching window " << window_us << " us" << std::endl;
+
+    request_batcher batcher{ std::chrono::microseconds(window_us) };
+    std::thread(&request_batcher::run, &batcher).detach();
+
+    for (;;) {
+        int client = accept(listener, nullptr, nullptr);
+        if (client < 0) {
+            if (errno == EINTR) continue;
+            throw std::runtime_error("accept: " + std::string(strerror(errno)));
+        }
+        std::thread(serve, client, std::ref(batcher)).detach();
+    }
+}
+catch (const std::exception& e) {
+    std::cerr << "sqrt_server: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+}
@@ -9,6 +9,10 @@
 #include <sstream>
 #include <bitset>
 
+#include <mathfunction/basic.hpp>
+
+#include <mathfunction/perf_counters.hpp>
+
 // Define the types
 using Posit16 = sw::universal::posit<16, 2>;
 using Posit32 = sw::universal::posit<32, 2>;
@@ -16,21 +20,6 @@ using Fixpnt16 = sw::universal::fixpnt<16, 8>;
 using Float = float;
 using Double = double;
 
-// Template square root calculation
-template <typename T>
-T calculate_sqrt(T value) {
-    if constexpr (std::is_same_v<T, Posit16> || std::is_same_v<T, Posit32>) {
-        return sqrt(value);
-    } else if constexpr (std::is_same_v<T, Fixpnt16>) {
-        if (value < 0) {
-            throw sw::universal::fixpnt_arithmetic_exception("argument to sqrt is negative");
-        }
-        return sw::universal::sqrt(value);
-    } else {
-        return sqrt(value);
-    }
-}
-
 // Function to print results
 template <typename T>
 void print_result(const std::string& type_name, T value, T result) {
@@ -53,6 +42,7 @@ void write_to_csv(const std::string& filename, const std::vector<std::vector<std
 }
 
 int main() {
+    profile_scope profile;   // run totals of the counters at the end, with MATHFUNCTION_PROFILE
     const double scale_factor = 1e-5; // Small numbers close to zero
     const int bitset_size = 16; // Number of bits to iterate over
 
@@ -154,6 +144,10 @@ int main() {
     std::cout << "Average Error Fixpnt16: " << avg_error_fixpnt16 << std::endl;
     std::cout << "Average Error Float: " << avg_error_float << std::endl;
 
+    // Hardware counters per type, read once per batch, with MATHFUNCTION_PROFILE
+    profile_range<Posit16, Posit32, Fixpnt16, Float, Double>("basic", { "Posit16", "Posit32", "Fixpnt16", "Float", "Double" },
+        scale_factor, bitset_size, [](auto x) { return calculate_sqrt(x); }, csv_data);
+
     write_to_csv("sqrt_comparison5.csv", csv_data);
 
     return 0;
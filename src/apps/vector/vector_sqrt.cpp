@@ -0,0 +1,86 @@
+// Element-wise sqrt and 2-norm of MTL4 dense vectors of each number type
+#include <universal/number/posit/posit.hpp>
+#include <universal/number/fixpnt/fixpnt.hpp>
+#include <cmath>
+#include <chrono>
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <vector>
+#include <string>
+
+#include <mathfunction/mtl_sqrt.hpp>
+
+// Define the types
+using Posit16 = sw::universal::posit<16, 2>;
+using Posit32 = sw::universal::posit<32, 2>;
+using Fixpnt16 = sw::universal::fixpnt<16, 8>;
+using Float = float;
+using Double = double;
+
+// Function to write data to CSV file
+void write_to_csv(const std::string& filename, const std::vector<std::vector<std::string>>& data) {
+    std::ofstream file(filename);
+    for (const auto& row : data) {
+        for (size_t i = 0; i < row.size(); ++i) {
+            file << row[i];
+            if (i < row.size() - 1) {
+                file << ",";
+            }
+        }
+        file << "\n";
+    }
+    file.close();
+}
+
+// Fill a vector with values in [1/16, 16) and time sqrt and two_norm against double
+template <typename T>
+void process_vector(const std::string& type_name, size_t n, std::vector<std::vector<std::string>>& csv_data) {
+    mtl::dense_vector<T> v(n);
+    for (size_t i = 0; i < n; ++i) {
+        v[i] = T(std::ldexp(1.0 + double(i % 1021) / 1021.0, int(i % 8) - 4));
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    mtl::dense_vector<T> roots = parallel_sqrt(v);
+    auto middle = std::chrono::steady_clock::now();
+    T norm = parallel_two_norm(v);
+    auto stop = std::chrono::steady_clock::now();
+
+    double total_error = 0.0;
+    double sum_of_squares = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        double x = static_cast<Double>(v[i]);
+        total_error += std::abs(static_cast<Double>(roots[i]) - std::sqrt(x));
+        sum_of_squares += x * x;
+    }
+    double avg_error = total_error / n;
+    double norm_error = std::abs(static_cast<Double>(norm) - std::sqrt(sum_of_squares)) / std::sqrt(sum_of_squares);
+    double sqrt_ns = std::chrono::duration<double, std::nano>(middle - start).count() / n;
+    double norm_ns = std::chrono::duration<double, std::nano>(stop - middle).count() / n;
+
+    std::cout << std::setw(10) << type_name << ": n = " << n
+              << ", sqrt " << sqrt_ns << " ns/element, Average Error: " << avg_error
+              << ", two_norm " << norm_ns << " ns/element, Relative Error: " << norm_error << std::endl;
+    csv_data.push_back({ type_name, std::to_string(n), std::to_string(sqrt_ns), std::to_string(avg_error),
+                         std::to_string(norm_ns), std::to_string(norm_error) });
+}
+
+int main() {
+    std::cout << std::scientific << std::setprecision(6);
+
+    std::vector<std::vector<std::string>> csv_data;
+    csv_data.push_back({"Type", "Elements", "sqrt ns/element", "sqrt Average Error", "two_norm ns/element", "two_norm Relative Error"});
+
+    for (size_t n : {size_t(1) << 10, size_t(1) << 16, size_t(1) << 20}) {
+        process_vector<Posit16>("Posit16", n, csv_data);
+        process_vector<Posit32>("Posit32", n, csv_data);
+        process_vector<Fixpnt16>("Fixpnt16", n, csv_data);
+        process_vector<Float>("Float", n, csv_data);
+        process_vector<Double>("Double", n, csv_data);
+    }
+
+    write_to_csv("vector_sqrt.csv", csv_data);
+
+    return 0;
+}
@@ -0,0 +1,159 @@
+// mathfunction.cpp: the C ABI of libmathfunction over the header-only kernels
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include <mathfunction/mathfunction.h>
+#include <mathfunction/fast_sqrt.hpp>
+#include <mathfunction/sqrt_batch.hpp>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#define MATHFUNCTION_HAS_X86_SIMD 1
+#endif
+
+static_assert(MF_ALGO_BASIC == static_cast<int>(sqrt_algorithm::basic) && MF_ALGO_GOLDSCHMIDT == static_cast<int>(sqrt_algorithm::goldschmidt),
+              "mf_algo mirrors sqrt_algorithm");
+
+namespace {
+
+using f32_batch = void (*)(const uint32_t*, uint32_t*, size_t);
+using f64_batch = void (*)(const uint64_t*, uint64_t*, size_t);
+
+template <typename Real, typename Word>
+void ieee_sqrt_scalar(const Word* in, Word* out, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        Real x;
+        std::memcpy(&x, &in[i], sizeof(x));
+        x = std::sqrt(x);
+        std::memcpy(&out[i], &x, sizeof(x));
+    }
+}
+
+#ifdef MATHFUNCTION_HAS_X86_SIMD
+__attribute__((target("avx2"))) void f32_sqrt_avx2(const uint32_t* in, uint32_t* out, size_t n) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 x = _mm256_loadu_ps(reinterpret_cast<const float*>(in + i));
+        _mm256_storeu_ps(reinterpret_cast<float*>(out + i), _mm256_sqrt_ps(x));
+    }
+    ieee_sqrt_scalar<float>(in + i, out + i, n - i);
+}
+
+__attribute__((target("avx2"))) void f64_sqrt_avx2(const uint64_t* in, uint64_t* out, size_t n) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d x = _mm256_loadu_pd(reinterpret_cast<const double*>(in + i));
+        _mm256_storeu_pd(reinterpret_cast<double*>(out + i), _mm256_sqrt_pd(x));
+    }
+    ieee_sqrt_scalar<double>(in + i, out + i, n - i);
+}
+
+__attribute__((target("avx512f"))) void f32_sqrt_avx512(const uint32_t* in, uint32_t* out, size_t n) {
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m512 x = _mm512_loadu_ps(in + i);
+        _mm512_storeu_ps(out + i, _mm512_sqrt_ps(x));
+    }
+    ieee_sqrt_scalar<float>(in + i, out + i, n - i);
+}
+
+__attribute__((target("avx512f"))) void f64_sqrt_avx512(const uint64_t* in, uint64_t* out, size_t n) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m512d x = _mm512_loadu_pd(in + i);
+        _mm512_storeu_pd(out + i, _mm512_sqrt_pd(x));
+    }
+    ieee_sqrt_scalar<double>(in + i, out + i, n - i);
+}
+#endif
+
+struct simd_kernels {
+    f32_batch f32;
+    f64_batch f64;
+    const char* features;
+};
+
+simd_kernels select_simd_kernels() {
+#ifdef MATHFUNCTION_HAS_X86_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) return { f32_sqrt_avx512, f64_sqrt_avx512, "avx512f" };
+    if (__builtin_cpu_supports("avx2")) return { f32_sqrt_avx2, f64_sqrt_avx2, "avx2" };
+#endif
+    return { ieee_sqrt_scalar<float, uint32_t>, ieee_sqrt_scalar<double, uint64_t>, "scalar" };
+}
+
+// picked once, while the library is loaded
+const simd_kernels simd = select_simd_kernels();
+
+// Hardware square root of n IEEE encodings; negative inputs (sign set, magnitude nonzero) become NaN
+template <typename Word, typename Batch>
+int ieee_basic(const Word* in, Word* out, size_t n, Batch batch) {
+    constexpr Word sign = Word(1) << (8 * sizeof(Word) - 1);
+    bool negative = false;
+    for (size_t i = 0; i < n; ++i) negative |= (in[i] > sign);
+    for_each_block(n, cache_block_elements<Word>(), [&](size_t first, size_t last, size_t) {
+        batch(in + first, out + first, last - first);
+    });
+    return negative ? MF_EDOM : MF_OK;
+}
+
+// An algorithm from the caller is only converted to the enums once it names one of them
+bool valid_algo(int algo) {
+    return algo >= MF_ALGO_BASIC && algo <= MF_ALGO_FAST;
+}
+
+template <typename T>
+int sqrt_encoded(const encoding_word_t<T>* in, encoding_word_t<T>* out, size_t n, int algo) {
+    if ((n > 0 && (in == nullptr || out == nullptr)) || !valid_algo(algo)) return MF_EINVAL;
+    if constexpr (std::is_same_v<T, float>) {
+        if (algo == MF_ALGO_BASIC) return ieee_basic(in, out, n, simd.f32);
+    } else if constexpr (std::is_same_v<T, double>) {
+        if (algo == MF_ALGO_BASIC) return ieee_basic(in, out, n, simd.f64);
+    }
+    bool ok = (algo == MF_ALGO_FAST)
+        ? sqrt_batch_encoded<T>(in, out, n, [](T x) { return fast_sqrt(x); })
+        : sqrt_batch_encoded<T>(static_cast<sqrt_algorithm>(algo), in, out, n);
+    return ok ? MF_OK : MF_EDOM;
+}
+
+} // namespace
+
+extern "C" {
+
+int mf_sqrt_posit16_u16(const uint16_t* in, uint16_t* out, size_t n, int algo) {
+    return sqrt_encoded<Posit16>(in, out, n, algo);
+}
+
+int mf_sqrt_posit32_u32(const uint32_t* in, uint32_t* out, size_t n, int algo) {
+    return sqrt_encoded<Posit32>(in, out, n, algo);
+}
+
+int mf_sqrt_fixpnt16_u16(const uint16_t* in, uint16_t* out, size_t n, int algo) {
+    return sqrt_encoded<Fixpnt16>(in, out, n, algo);
+}
+
+int mf_sqrt_float_u32(const uint32_t* in, uint32_t* out, size_t n, int algo) {
+    return sqrt_encoded<Float>(in, out, n, algo);
+}
+
+int mf_sqrt_double_u64(const uint64_t* in, uint64_t* out, size_t n, int algo) {
+    return sqrt_encoded<Double>(in, out, n, algo);
+}
+
+int mf_abi_version(void) {
+    return MF_ABI_VERSION;
+}
+
+const char* mf_algo_name(int algo) {
+    if (!valid_algo(algo)) return "unknown";
+    if (algo == MF_ALGO_FAST) return "fast";
+    return sqrt_algorithm_name(static_cast<sqrt_algorithm>(algo));
+}
+
+const char* mf_cpu_features(void) {
+    return simd.features;
+}
+
+} // extern "C"
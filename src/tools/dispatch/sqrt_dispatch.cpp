@@ -0,0 +1,149 @@
+// sqrt_dispatch: offline generator of the per-exponent-bucket kernel tables behind fast_sqrt
+//
+// Splits the exponent range of every sweep type into buckets, samples each
+// bucket log-uniformly, and picks the fastest kernel whose max ULP error stays
+// within the target, or the most accurate kernel when none does. Timings are
+// machine specific, so the build runs it on the build machine, into the
+// generated headers (src/tools/dispatch/CMakeLists.txt).
+//
+//   sqrt_dispatch --output <header> [--max-ulp 1] [--buckets 16] [--samples 256]
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <mathfunction/sqrt_kernels.hpp>
+#include <mathfunction/perf_counters.hpp>
+#include <mathfunction/ulp.hpp>
+
+struct BucketChoice {
+    int lo, hi;             // binary exponents covered
+    std::string algorithm;
+    double ns_per_op;
+    double max_ulp;
+};
+
+// Max ULP error of kernel on inputs, infinite when it throws or returns NaN
+template <typename T, typename Kernel>
+double max_ulp_error(Kernel kernel, const std::vector<T>& inputs) {
+    double worst = 0.0;
+    try {
+        for (const T& x : inputs) {
+            double error = ulp_error(kernel(x), x);
+            worst = std::max(worst, std::isnan(error) ? INFINITY : error);
+        }
+    } catch (const std::exception&) {
+        return INFINITY;
+    }
+    return worst;
+}
+
+template <typename T>
+std::vector<BucketChoice> measure_type(double target, int bucket_count, size_t samples, int& min_exponent, int& bucket_width) {
+    min_exponent = binary_exponent(next_up(T(0)));
+    int max_exponent = binary_exponent(std::numeric_limits<T>::max());
+    bucket_width = (max_exponent - min_exponent + bucket_count) / bucket_count;
+
+    std::mt19937_64 rng(0x5eed);
+    std::vector<BucketChoice> choices;
+    for (int lo = min_exponent; lo <= max_exponent; lo += bucket_width) {
+        int hi = std::min(lo + bucket_width - 1, max_exponent);
+        std::uniform_real_distribution<double> exponent(lo, hi + 1);
+        std::vector<T> inputs;
+        while (inputs.size() < samples) {
+            T x(std::exp2(exponent(rng)));
+            if (x > T(0)) inputs.push_back(x);
+        }
+
+        BucketChoice best{ lo, hi, "", INFINITY, INFINITY };
+        BucketChoice accurate = best;
+        for_each_kernel([&](auto kernel) {
+            double ulp = max_ulp_error<T>(kernel, inputs);
+            if (ulp == INFINITY) return;
+            std::vector<T> roots(inputs.size());
+            double ns = best_ns_per_call([&]() {
+                for (size_t i = 0; i < inputs.size(); ++i) roots[i] = kernel(inputs[i]);
+            }, inputs.size());
+            if (ulp <= target && ns < best.ns_per_op) best = { lo, hi, kernel.name, ns, ulp };
+            if (ulp < accurate.max_ulp) accurate = { lo, hi, kernel.name, ns, ulp };
+        });
+        choices.push_back(best.algorithm.empty() ? accurate : best);
+        std::cerr << number_type_name<T>::value << " [" << lo << ", " << hi << "]: " << choices.back().algorithm << std::endl;
+    }
+    return choices;
+}
+
+template <typename T>
+void emit_type(std::ostream& out, double target, int bucket_count, size_t samples) {
+    int min_exponent, bucket_width;
+    std::vector<BucketChoice> choices = measure_type<T>(target, bucket_count, samples, min_exponent, bucket_width);
+
+    out << "template <>\nstruct sqrt_dispatch<" << number_type_name<T>::value << "> {\n";
+    out << "    static constexpr int min_exponent = " << min_exponent << ";\n";
+    out << "    static constexpr int bucket_width = " << bucket_width << ";\n";
+    out << "    static constexpr int buckets = " << choices.size() << ";\n";
+    // the largest error measured on the chosen kernels, above the target where a bucket has none within it
+    double max_ulp = 0.0;
+    for (const auto& c : choices) max_ulp = std::max(max_ulp, c.max_ulp);
+    if (!std::isfinite(max_ulp)) throw std::runtime_error(std::string("no kernel computes every sample of ") + number_type_name<T>::value);
+    out << "    static constexpr double max_ulp = " << std::setprecision(17) << max_ulp << ";\n";
+    out << "    static constexpr sqrt_algorithm kernel[] = {\n";
+    out << std::setprecision(3);
+    for (size_t b = 0; b < choices.size(); ++b) {
+        const auto& c = choices[b];
+        std::ostringstream entry;
+        entry << "sqrt_algorithm::" << c.algorithm << (b + 1 < choices.size() ? "," : "");
+        out << "        " << std::left << std::setw(32) << entry.str() << std::right
+            << "// [" << c.lo << ", " << c.hi << "]: " << c.ns_per_op << " ns, " << c.max_ulp << " ulp\n";
+    }
+    out << "    };\n};\n\n";
+}
+
+int main(int argc, char** argv)
+try {
+    std::string output;
+    double target = 1.0;
+    int bucket_count = 16;
+    size_t samples = 256;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) throw std::runtime_error("missing value for " + arg);
+        if (arg == "--output") output = argv[++i];
+        else if (arg == "--max-ulp") target = std::stod(argv[++i]);
+        else if (arg == "--buckets") bucket_count = std::stoi(argv[++i]);
+        else if (arg == "--samples") samples = std::stoul(argv[++i]);
+        else throw std::runtime_error("unknown argument " + arg);
+    }
+    if (output.empty() || bucket_count < 1 || samples == 0) {
+        std::cerr << "Usage: sqrt_dispatch --output <header> [--max-ulp 1] [--buckets 16] [--samples 256]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::ostringstream header;
+    header << "#pragma once\n";
+    header << "// sqrt_dispatch_table.hpp: generated by the sqrt_dispatch tool, do not edit\n";
+    header << "//\n";
+    header << "// Included by fast_sqrt.hpp. Measured on the build machine by the\n";
+    header << "// sqrt_dispatch_table target; each entry is the fastest kernel within\n";
+    header << "// " << target << " ulp on its exponent bucket, or the most accurate one when none\n";
+    header << "// is, and max_ulp the largest error measured on the chosen kernels.\n\n";
+    for_each_type([&](auto type) {
+        using T = typename decltype(type)::type;
+        emit_type<T>(header, target, bucket_count, samples);
+    });
+
+    std::ofstream file(output);
+    file << header.str();
+    file.close();
+    return file ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+catch (const std::exception& e) {
+    std::cerr << "sqrt_dispatch: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+}
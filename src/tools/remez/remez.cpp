@@ -0,0 +1,285 @@
+// remez: build-time generator of minimax polynomial coefficient tables
+//
+// Runs the Remez exchange algorithm for each requested function on its
+// interval and emits constexpr coefficient arrays into a header. The kernels
+// refine the polynomial with iterations that each double its correct bits,
+// so the degree for a number type is the one of least total cost: its
+// Horner steps plus the refinement steps it still needs, each weighted by
+// the step cost of the function in multiply-adds. The header carries every
+// degree and a constexpr choice that applies the same cost model.
+//
+//   remez --output <header> --function sqrt:1:4:8:6 --type Posit16=12 ...
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using real = long double;
+
+struct FunctionSpec {
+    std::string name;
+    real lo, hi;
+    int maxDegree;
+    int stepCost;       // one refinement step, in Horner steps
+};
+
+struct TypeSpec {
+    std::string name;
+    int bits;
+};
+
+struct Approximation {
+    int degree;
+    std::vector<real> coefficients; // monomial coefficients in t on [-1,1]
+    real maxRelError;
+};
+
+// Functions the generator knows how to approximate
+std::function<real(real)> lookup_function(const std::string& name) {
+    if (name == "sqrt") return [](real x) { return std::sqrt(x); };
+    if (name == "rsqrt") return [](real x) { return 1.0L / std::sqrt(x); };
+    throw std::runtime_error("unknown function " + name);
+}
+
+// Gaussian elimination with partial pivoting
+std::vector<real> solve(std::vector<std::vector<real>> A, std::vector<real> b) {
+    size_t n = b.size();
+    for (size_t c = 0; c < n; ++c) {
+        size_t pivot = c;
+        for (size_t r = c + 1; r < n; ++r) {
+            if (std::fabs(A[r][c]) > std::fabs(A[pivot][c])) pivot = r;
+        }
+        std::swap(A[c], A[pivot]);
+        std::swap(b[c], b[pivot]);
+        for (size_t r = c + 1; r < n; ++r) {
+            real f = A[r][c] / A[c][c];
+            for (size_t k = c; k < n; ++k) A[r][k] -= f * A[c][k];
+            b[r] -= f * b[c];
+        }
+    }
+    std::vector<real> x(n);
+    for (size_t i = n; i-- > 0;) {
+        real s = b[i];
+        for (size_t k = i + 1; k < n; ++k) s -= A[i][k] * x[k];
+        x[i] = s / A[i][i];
+    }
+    return x;
+}
+
+real horner(const std::vector<real>& c, real t) {
+    real s = 0;
+    for (size_t i = c.size(); i-- > 0;) s = s * t + c[i];
+    return s;
+}
+
+// Relative-error minimax polynomial of the given degree for f on [lo,hi],
+// expressed in the normalized variable t = (2x - (lo + hi)) / (hi - lo)
+Approximation remez(const std::function<real(real)>& f, real lo, real hi, int degree) {
+    auto x_of = [&](real t) { return (lo + hi) / 2 + (hi - lo) / 2 * t; };
+    const int n = degree + 2;
+    const int samples = 4000;
+
+    // start from the Chebyshev extrema
+    std::vector<real> reference(n);
+    for (int i = 0; i < n; ++i) reference[i] = -std::cos(M_PIl * i / (n - 1));
+
+    std::vector<real> c(degree + 1);
+    real maxError = 0;
+    for (int iteration = 0; iteration < 60; ++iteration) {
+        // p(t_i) / f(t_i) + (-1)^i E = 1
+        std::vector<std::vector<real>> A(n, std::vector<real>(n));
+        std::vector<real> rhs(n, 1.0L);
+        for (int i = 0; i < n; ++i) {
+            real fx = f(x_of(reference[i]));
+            real p = 1;
+            for (int k = 0; k <= degree; ++k) {
+                A[i][k] = p / fx;
+                p *= reference[i];
+            }
+            A[i][degree + 1] = (i & 1) ? -1 : 1;
+        }
+        std::vector<real> s = solve(A, rhs);
+        for (int k = 0; k <= degree; ++k) c[k] = s[k];
+        real levelledError = std::fabs(s[degree + 1]);
+
+        auto error = [&](real t) { return horner(c, t) / f(x_of(t)) - 1; };
+        std::vector<real> ts(samples + 1), es(samples + 1);
+        for (int i = 0; i <= samples; ++i) {
+            ts[i] = -1 + 2 * real(i) / samples;
+            es[i] = error(ts[i]);
+        }
+
+        // one extremum per run of equal sign, refined by ternary search
+        std::vector<real> extrema;
+        for (int i = 0; i <= samples;) {
+            int j = i, best = i;
+            while (j <= samples && std::signbit(es[j]) == std::signbit(es[i])) {
+                if (std::fabs(es[j]) > std::fabs(es[best])) best = j;
+                ++j;
+            }
+            real a = ts[std::max(best - 1, 0)], b = ts[std::min(best + 1, samples)];
+            for (int g = 0; g < 80; ++g) {
+                real m1 = a + (b - a) / 3, m2 = b - (b - a) / 3;
+                if (std::fabs(error(m1)) < std::fabs(error(m2))) a = m1; else b = m2;
+            }
+            extrema.push_back(best == 0 ? -1.0L : (best == samples ? 1.0L : (a + b) / 2));
+            i = j;
+        }
+        while (static_cast<int>(extrema.size()) > n) {
+            if (std::fabs(error(extrema.front())) < std::fabs(error(extrema.back()))) {
+                extrema.erase(extrema.begin());
+            } else {
+                extrema.pop_back();
+            }
+        }
+
+        maxError = 0;
+        for (real e : es) maxError = std::max(maxError, std::fabs(e));
+        if (static_cast<int>(extrema.size()) == n) reference = extrema;
+        if (maxError - levelledError < 1e-6L * levelledError) break;
+    }
+    return { degree, c, maxError };
+}
+
+real bits_of(const Approximation& a) {
+    return -std::log2(a.maxRelError);
+}
+
+// bits as written to the header, so that the choice here and the one the
+// header makes at compile time see the same numbers
+double printed_bits(const Approximation& a) {
+    std::ostringstream text;
+    text << std::setprecision(4) << double(bits_of(a));
+    return std::stod(text.str());
+}
+
+// refinement steps from bits to target bits, each doubling the correct bits less one
+int refinements(double bits, int target) {
+    int steps = 0;
+    while (bits < target && steps < 64) {
+        bits = 2.0 * bits - 1.0;
+        ++steps;
+    }
+    return steps;
+}
+
+FunctionSpec parse_function(const std::string& arg) {
+    // name:lo:hi:maxdegree:stepcost
+    std::stringstream ss(arg);
+    std::string name, lo, hi, degree, cost;
+    if (!std::getline(ss, name, ':') || !std::getline(ss, lo, ':') || !std::getline(ss, hi, ':') || !std::getline(ss, degree, ':') ||
+        !std::getline(ss, cost, ':')) {
+        throw std::runtime_error("malformed function spec " + arg);
+    }
+    return { name, std::stold(lo), std::stold(hi), std::stoi(degree), std::stoi(cost) };
+}
+
+TypeSpec parse_type(const std::string& arg) {
+    // name=bits
+    size_t eq = arg.find('=');
+    if (eq == std::string::npos) throw std::runtime_error("malformed type spec " + arg);
+    return { arg.substr(0, eq), std::stoi(arg.substr(eq + 1)) };
+}
+
+void emit_function(std::ostream& out, const FunctionSpec& fs, const std::vector<TypeSpec>& types) {
+    auto f = lookup_function(fs.name);
+
+    std::vector<Approximation> approximations;
+    for (int d = 1; d <= fs.maxDegree; ++d) approximations.push_back(remez(f, fs.lo, fs.hi, d));
+
+    // degree of least Horner plus refinement cost per type, the lower degree on a tie
+    std::map<std::string, int> chosen, steps;
+    for (const auto& type : types) {
+        int best = 0, bestCost = 0;
+        for (const auto& a : approximations) {
+            int cost = a.degree + refinements(printed_bits(a), type.bits) * fs.stepCost;
+            if (best == 0 || cost < bestCost) { best = a.degree; bestCost = cost; }
+        }
+        chosen[type.name] = best;
+        steps[type.name] = refinements(printed_bits(approximations[best - 1]), type.bits);
+    }
+
+    const std::string table = "remez_" + fs.name;
+    out << "// " << fs.name << "(x) on [" << double(fs.lo) << ", " << double(fs.hi) << "), relative minimax polynomials\n";
+    out << "// in t = (2x - (lo + hi)) / (hi - lo); bits = -log2(max relative error)\n";
+    out << "// a refinement step costs " << fs.stepCost << " Horner steps\n";
+    for (const auto& type : types) {
+        out << "//   " << type.name << " (" << type.bits << " bits): degree " << chosen[type.name] << ", "
+            << steps[type.name] << (steps[type.name] == 1 ? " refinement\n" : " refinements\n");
+    }
+    out << "template <int Degree>\nstruct " << table << ";\n\n";
+    out << std::setprecision(21);
+    for (const auto& a : approximations) {
+        const int d = a.degree;
+        out << "template <>\nstruct " << table << "<" << d << "> {\n";
+        out << "    static constexpr int degree = " << d << ";\n";
+        out << "    static constexpr double lo = " << double(fs.lo) << ";\n";
+        out << "    static constexpr double hi = " << double(fs.hi) << ";\n";
+        out << "    static constexpr double bits = " << printed_bits(a) << ";\n";
+        out << "    static constexpr double c[] = {\n";
+        for (size_t k = 0; k < a.coefficients.size(); ++k) {
+            out << "        " << a.coefficients[k] << (k + 1 < a.coefficients.size() ? ",\n" : "\n");
+        }
+        out << "    };\n};\n\n";
+    }
+
+    // compile-time choice of the degree of least total cost for a precision
+    out << "constexpr int " << table << "_step_cost = " << fs.stepCost << ";\n\n";
+    out << "constexpr int " << table << "_degree(int bits) {\n";
+    out << "    constexpr double table_bits[] = {";
+    for (const auto& a : approximations) out << (a.degree > 1 ? ", " : " ") << table << "<" << a.degree << ">::bits";
+    out << " };\n";
+    out << "    int best = 0, best_cost = 0;\n";
+    out << "    for (int degree = 1; degree <= " << fs.maxDegree << "; ++degree) {\n";
+    out << "        int cost = degree + remez_refinements(table_bits[degree - 1], bits) * " << table << "_step_cost;\n";
+    out << "        if (best == 0 || cost < best_cost) { best = degree; best_cost = cost; }\n";
+    out << "    }\n";
+    out << "    return best;\n}\n\n";
+}
+
+int main(int argc, char** argv)
+try {
+    std::string output;
+    std::vector<FunctionSpec> functions;
+    std::vector<TypeSpec> types;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) throw std::runtime_error("missing value for " + arg);
+        if (arg == "--output") output = argv[++i];
+        else if (arg == "--function") functions.push_back(parse_function(argv[++i]));
+        else if (arg == "--type") types.push_back(parse_type(argv[++i]));
+        else throw std::runtime_error("unknown argument " + arg);
+    }
+    if (output.empty() || functions.empty() || types.empty()) {
+        std::cerr << "Usage: remez --output <header> --function name:lo:hi:maxdegree:stepcost... --type name=bits..." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::ostringstream header;
+    header << "#pragma once\n";
+    header << "// remez_coefficients.hpp: generated by the remez tool at build time, do not edit\n\n";
+    header << "// refinement steps from bits to target bits, each doubling the correct bits less one\n";
+    header << "constexpr int remez_refinements(double bits, int target) {\n";
+    header << "    int steps = 0;\n";
+    header << "    while (bits < target && steps < 64) {\n";
+    header << "        bits = 2.0 * bits - 1.0;\n";
+    header << "        ++steps;\n";
+    header << "    }\n";
+    header << "    return steps;\n}\n\n";
+    for (const auto& fs : functions) emit_function(header, fs, types);
+
+    std::ofstream file(output);
+    file << header.str();
+    file.close();
+    return file ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+catch (const std::exception& e) {
+    std::cerr << "remez: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+}
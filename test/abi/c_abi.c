@@ -0,0 +1,74 @@
+/* c_abi.c: libmathfunction called from C, every type through every algorithm */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <mathfunction/mathfunction.h>
+
+static uint32_t float_bits(float f) { uint32_t u; memcpy(&u, &f, sizeof(u)); return u; }
+static float bits_float(uint32_t u) { float f; memcpy(&f, &u, sizeof(f)); return f; }
+static uint64_t double_bits(double d) { uint64_t u; memcpy(&u, &d, sizeof(u)); return u; }
+static double bits_double(uint64_t u) { double d; memcpy(&d, &u, sizeof(d)); return d; }
+
+#define COUNT 100000
+
+int main(void) {
+	static uint32_t f_in[COUNT], f_out[COUNT];
+	static uint64_t d_in[COUNT], d_out[COUNT];
+	static uint16_t h_in[COUNT], h_out[COUNT];
+	static uint32_t w_in[COUNT], w_out[COUNT];
+	int failures = 0;
+
+	for (int i = 0; i < COUNT; ++i) {
+		double x = pow(2.0, -20.0 + 40.0 * i / COUNT);
+		f_in[i] = float_bits((float)x);
+		d_in[i] = double_bits(x);
+		h_in[i] = (uint16_t)(0x4000 + i % 0x1000);   /* posit16 and fixpnt16 encodings of positive values */
+		w_in[i] = 0x40000000u + (uint32_t)i;
+	}
+
+	for (int a = MF_ALGO_BASIC; a <= MF_ALGO_FAST; ++a) {
+		mf_algo algo = (mf_algo)a;
+		/* the iterative kernels are slow and lose accuracy far below 1: a prefix, status only */
+		int iterative = (algo == MF_ALGO_CORDIC || algo == MF_ALGO_BAKHSHALI || algo == MF_ALGO_HERON);
+		size_t n = iterative ? 1000 : COUNT;
+
+		if (mf_sqrt_float_u32(f_in, f_out, n, algo) != MF_OK) ++failures;
+		if (mf_sqrt_double_u64(d_in, d_out, n, algo) != MF_OK) ++failures;
+		for (size_t i = 0; !iterative && i < n; i += 997) {
+			double fx = bits_float(f_in[i]), dx = bits_double(d_in[i]);
+			if (fabs(bits_float(f_out[i]) - sqrt(fx)) > 1e-5 * sqrt(fx)) {
+				fprintf(stderr, "float %s: sqrt(%g) = %g\n", mf_algo_name(algo), fx, bits_float(f_out[i]));
+				++failures;
+			}
+			if (fabs(bits_double(d_out[i]) - sqrt(dx)) > 1e-12 * sqrt(dx)) {
+				fprintf(stderr, "double %s: sqrt(%g) = %g\n", mf_algo_name(algo), dx, bits_double(d_out[i]));
+				++failures;
+			}
+		}
+
+		/* positive encodings map to positive encodings */
+		if (mf_sqrt_posit16_u16(h_in, h_out, n, algo) != MF_OK) ++failures;
+		if (mf_sqrt_posit32_u32(w_in, w_out, n, algo) != MF_OK) ++failures;
+		for (size_t i = 0; i < n; i += 997) {
+			if (h_out[i] == 0 || (h_out[i] & 0x8000u) || w_out[i] == 0 || (w_out[i] & 0x80000000u)) {
+				fprintf(stderr, "posit %s: encoding %zu maps to a non-positive value\n", mf_algo_name(algo), i);
+				++failures;
+			}
+		}
+		if (mf_sqrt_fixpnt16_u16(h_in, h_out, n, algo) != MF_OK) ++failures;
+	}
+
+	/* in place, negative inputs and bad arguments */
+	f_in[0] = float_bits(-1.0f);
+	if (mf_sqrt_float_u32(f_in, f_in, 1, MF_ALGO_BASIC) != MF_EDOM || !isnan(bits_float(f_in[0]))) ++failures;
+	if (mf_sqrt_float_u32(NULL, f_out, 1, MF_ALGO_BASIC) != MF_EINVAL) ++failures;
+	if (mf_sqrt_double_u64(d_in, d_out, 1, 42) != MF_EINVAL) ++failures;
+	if (mf_sqrt_posit32_u32(w_in, w_out, 1, -1) != MF_EINVAL || mf_sqrt_float_u32(f_in, f_out, 1, MF_ALGO_FAST + 1) != MF_EINVAL) ++failures;
+	if (strcmp(mf_algo_name(-1), "unknown") != 0 || strcmp(mf_algo_name(MF_ALGO_FAST), "fast") != 0) ++failures;
+	if (mf_abi_version() != MF_ABI_VERSION) ++failures;
+
+	printf("libmathfunction (%s): %s\n", mf_cpu_features(), failures == 0 ? "PASS" : "FAIL");
+	return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
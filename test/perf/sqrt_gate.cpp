@@ -0,0 +1,241 @@
+// sqrt_gate.cpp: performance regression gate for every (algorithm, type) pair
+//
+//   perf_sqrt_gate                  compare against the checked-in baseline
+//   perf_sqrt_gate --update [file]  rewrite the baseline with this machine's numbers
+//
+// Costs are stored relative to a fixed dependent multiply-add chain, which
+// keeps the baseline meaningful across machines of the same class. An entry
+// fails when its relative cost exceeds baseline * (1 + tolerance) in three
+// passes, each against a fresh reference chain, and so does a pair
+// without a baseline entry. --update writes the median of five interleaved
+// passes, with a tolerance of twice the spread it saw above the median;
+// a new kernel or type needs --update. The gate is built at -O2 whatever the build type (test/perf/CMakeLists.txt);
+// PGO-instrumented builds, whose counters slow every kernel down, and
+// unoptimized builds with other compilers only report. So does a build whose
+// Universal revision is not the one the baseline records, since the posit and
+// fixpnt costs are those of its emulation.
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <bitset>
+
+#include <mathfunction/sqrt_kernels.hpp>
+#include <mathfunction/perf_counters.hpp>
+
+#ifndef MATHFUNCTION_PERF_BASELINE
+#define MATHFUNCTION_PERF_BASELINE "sqrt_baseline.csv"
+#endif
+#ifndef MATHFUNCTION_PERF_UNIVERSAL
+#define MATHFUNCTION_PERF_UNIVERSAL ""
+#endif
+
+struct baseline_entry {
+	double relative_cost;
+	double tolerance;
+};
+
+using baseline_map = std::map<std::pair<std::string, std::string>, baseline_entry>;
+
+// the comment line of the baseline that names the Universal revision it was measured with
+const std::string universal_prefix = "# measured with universal ";
+
+constexpr double default_tolerance = 0.5;
+
+// ns per step of a dependent multiply-add chain: the unit of the baseline
+double reference_ns() {
+	volatile double seed = 1.0000001;
+	return best_ns_per_call([&]() {
+		double x = seed;
+		for (int i = 0; i < 4096; ++i) x = x * 0.9999999 + 1e-7;
+		seed = x;
+	}, 4096);
+}
+
+// Entries of the baseline in filename; universal receives its Universal revision, empty when it records none
+baseline_map read_baseline(const std::string& filename, std::string& universal) {
+	baseline_map baseline;
+	std::ifstream file(filename);
+	std::string line;
+	std::getline(file, line); // header
+	while (std::getline(file, line)) {
+		if (line.rfind(universal_prefix, 0) == 0) universal = line.substr(universal_prefix.size());
+		if (line.empty() || line[0] == '#') continue;
+		std::stringstream ss(line);
+		std::string algorithm, type_name, cost, tolerance;
+		if (std::getline(ss, algorithm, ',') && std::getline(ss, type_name, ',') && std::getline(ss, cost, ',') && std::getline(ss, tolerance, ',')) {
+			baseline[{ algorithm, type_name }] = { std::stod(cost), std::stod(tolerance) };
+		}
+	}
+	return baseline;
+}
+
+void write_baseline(const std::string& filename, const baseline_map& baseline) {
+	std::ofstream file(filename);
+	file << "Algorithm,Type,Relative Cost,Tolerance\n";
+	file << "# cost per call in steps of a dependent multiply-add chain; regenerate with perf_sqrt_gate --update\n";
+#if defined(__clang__)
+	file << "# measured with clang " << __clang_version__ << "\n";
+#elif defined(__GNUC__)
+	file << "# measured with gcc " << __VERSION__ << "\n";
+#endif
+	file << universal_prefix << MATHFUNCTION_PERF_UNIVERSAL << "\n";
+	for (const auto& [key, entry] : baseline) {
+		file << key.first << "," << key.second << "," << entry.relative_cost << "," << entry.tolerance << "\n";
+	}
+}
+
+int main(int argc, char** argv)
+try {
+	bool update = false;
+	std::string filename = MATHFUNCTION_PERF_BASELINE;
+	if (argc > 1 && std::string(argv[1]) == "--update") {
+		update = true;
+		if (argc > 2) filename = argv[2];
+	}
+#ifdef MATHFUNCTION_PERF_REPORT_ONLY
+	const bool enforced = false;
+#else
+	const bool enforced = true;
+#endif
+
+	// the inputs of the drivers, plus a unit range that every type represents
+	std::vector<double> values;
+	const int bitset_size = 16; // Number of bits to iterate over
+	for (double scale_factor : { 1.0 / 1024, 1e-5, 1e-7, 1e-9 }) {
+		for (int i = 0; i < bitset_size; ++i) {
+			values.push_back(static_cast<double>(std::bitset<bitset_size>(1 << i).to_ulong()) * scale_factor);
+		}
+	}
+
+	// one probe per pair, measuring its cost in the current unit
+	struct probe {
+		std::string algorithm, type_name;
+		std::function<double()> measure;
+		std::vector<double> costs;
+	};
+	std::vector<probe> probes;
+	double unit = reference_ns();
+	for_each_type([&](auto type) {
+		using T = typename decltype(type)::type;
+		auto inputs = std::make_shared<std::vector<T>>();
+		for (double value : values) {
+			T x(value);
+			if (x > T(0)) inputs->push_back(x);
+		}
+		auto results = std::make_shared<std::vector<T>>(inputs->size());
+		for_each_kernel([&](auto kernel) {
+			probes.push_back({ kernel.name, number_type_name<T>::value, [inputs, results, kernel, &unit]() {
+				return best_ns_per_call([&]() {
+					for (size_t i = 0; i < inputs->size(); ++i) (*results)[i] = kernel((*inputs)[i]);
+				}, inputs->size()) / unit;
+			}, {} });
+		});
+	});
+
+	// a pass measures the given probes once each; kernels that throw on these inputs are dropped
+	auto pass = [&](const std::vector<probe*>& selected) {
+		unit = reference_ns();
+		for (probe* p : selected) {
+			try {
+				p->costs.push_back(p->measure());
+			} catch (const std::exception& e) {
+				std::cout << std::setw(12) << p->algorithm << std::setw(10) << p->type_name << ": skipped, " << e.what() << std::endl;
+				p->measure = nullptr;
+			}
+		}
+	};
+	std::vector<probe*> all;
+	for (auto& p : probes) all.push_back(&p);
+	std::string baseline_universal;
+	baseline_map baseline = read_baseline(filename, baseline_universal);
+	auto limit = [&](const probe& p) {
+		const baseline_entry& entry = baseline.at({ p.algorithm, p.type_name });
+		return entry.relative_cost * (1.0 + entry.tolerance);
+	};
+	auto best = [](const probe& p) { return *std::min_element(p.costs.begin(), p.costs.end()); };
+
+	if (update) {
+		// interleaved passes, so that a slow spell of the machine touches every pair alike;
+		// the baseline is the median pass, the tolerance twice the spread above it
+		baseline_map measured;
+		for (int run = 0; run < 5; ++run) pass(all);
+		for (const auto& p : probes) {
+			if (!p.measure) continue;
+			std::vector<double> costs = p.costs;
+			std::sort(costs.begin(), costs.end());
+			const double median = costs[costs.size() / 2];
+			measured[{ p.algorithm, p.type_name }] = { median, std::max(default_tolerance, 2.0 * (costs.back() / median - 1.0)) };
+		}
+		write_baseline(filename, measured);
+		std::cout << "baseline written to " << filename << std::endl;
+		return EXIT_SUCCESS;
+	}
+
+	// a regression has to reproduce: pairs over their limit are measured again in
+	// two later passes, after a pause, and keep their best cost
+	pass(all);
+	for (int retry = 0; retry < 2; ++retry) {
+		std::vector<probe*> over;
+		for (probe* p : all) {
+			if (p->measure && baseline.count({ p->algorithm, p->type_name }) && best(*p) > limit(*p)) over.push_back(p);
+		}
+		if (over.empty()) break;
+		std::this_thread::sleep_for(std::chrono::milliseconds(500));
+		pass(over);
+	}
+
+	int regressions = 0;
+	std::cout << std::fixed << std::setprecision(2);
+	for (const auto& p : probes) {
+		if (!p.measure) continue;
+		std::cout << std::setw(12) << p.algorithm << std::setw(10) << p.type_name << ": " << std::setw(12) << best(p);
+		auto it = baseline.find({ p.algorithm, p.type_name });
+		if (it == baseline.end()) {
+			std::cout << "  MISSING from the baseline" << std::endl;
+			++regressions;
+		} else if (best(p) > limit(p)) {
+			std::cout << "  REGRESSION, baseline " << it->second.relative_cost << " +" << it->second.tolerance * 100 << "%" << std::endl;
+			++regressions;
+		} else {
+			std::cout << "  baseline " << it->second.relative_cost << std::endl;
+		}
+	}
+
+	if (!enforced) {
+		std::cout << "instrumented or unoptimized build: " << regressions << " regressions reported, gate not enforced" << std::endl;
+		return EXIT_SUCCESS;
+	}
+	if (baseline_universal.empty() || baseline_universal != MATHFUNCTION_PERF_UNIVERSAL) {
+		std::cout << "baseline measured with Universal " << (baseline_universal.empty() ? "of unknown revision" : baseline_universal)
+		          << ", this build uses " << MATHFUNCTION_PERF_UNIVERSAL << ": " << regressions << " regressions reported, gate not enforced" << std::endl;
+		return EXIT_SUCCESS;
+	}
+	std::cout << "perf gate: " << (regressions == 0 ? "PASS" : "FAIL") << std::endl;
+	return (regressions == 0 ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+catch (const char* msg) {
+	std::cerr << msg << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const sw::universal::universal_arithmetic_exception& err) {
+	std::cerr << "Unprocessed universal arithmetic exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const sw::universal::universal_internal_exception& err) {
+	std::cerr << "Unprocessed universal internal exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (...) {
+	std::cerr << "Caught unknown exception" << std::endl;
+	return EXIT_FAILURE;
+}
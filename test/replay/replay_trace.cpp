@@ -0,0 +1,149 @@
+// replay_trace.cpp: replay over a small mapped trace in chunks of three, its stats and output encodings, and the inputs it rejects
+//
+//   replay_trace <path to replay>
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <mathfunction/sqrt_algorithm.hpp>
+#include <mathfunction/encoding.hpp>
+
+// Exit status of replay run in directory with arguments, -1 when it did not exit
+int run(const std::string& replay, const std::string& directory, const std::vector<std::string>& arguments) {
+	pid_t child = fork();
+	if (child < 0) throw std::runtime_error("fork failed");
+	if (child == 0) {
+		std::vector<char*> argv{ const_cast<char*>(replay.c_str()) };
+		for (const auto& argument : arguments) argv.push_back(const_cast<char*>(argument.c_str()));
+		argv.push_back(nullptr);
+		if (chdir(directory.c_str()) == 0) execv(replay.c_str(), argv.data());
+		_exit(127);
+	}
+	int status = 0;
+	waitpid(child, &status, 0);
+	return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+
+template <typename Word>
+void write_file(const std::string& path, const std::vector<Word>& words, size_t extra_bytes = 0) {
+	std::ofstream file(path, std::ios::binary);
+	file.write(reinterpret_cast<const char*>(words.data()), static_cast<std::streamsize>(words.size() * sizeof(Word)));
+	for (size_t i = 0; i < extra_bytes; ++i) file.put(0);
+}
+
+template <typename Word>
+std::vector<Word> read_file(const std::string& path) {
+	std::ifstream file(path, std::ios::binary);
+	std::vector<char> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+	std::vector<Word> words(bytes.size() / sizeof(Word));
+	std::copy(bytes.begin(), bytes.begin() + words.size() * sizeof(Word), reinterpret_cast<char*>(words.data()));
+	return words;
+}
+
+// The csv row of a pair: Algorithm, Type, Inputs, Skipped, Failures, Max ULP, ...
+std::vector<std::string> report_row(const std::string& directory, const std::string& algorithm, const std::string& type_name) {
+	std::ifstream file(directory + "/sqrt_replay.csv");
+	std::string line;
+	while (std::getline(file, line)) {
+		std::vector<std::string> cells;
+		std::stringstream ss(line);
+		std::string cell;
+		while (std::getline(ss, cell, ',')) cells.push_back(cell);
+		if (cells.size() > 5 && cells[0] == algorithm && cells[1] == type_name) return cells;
+	}
+	return {};
+}
+
+// Results of one pair: the root of every positive input, zero for the skipped ones
+template <typename T>
+int verify_output(const std::string& path, const std::vector<double>& values) {
+	std::vector<encoding_word_t<T>> results = read_file<encoding_word_t<T>>(path);
+	if (results.size() != values.size()) {
+		std::cerr << path << ": " << results.size() << " results for " << values.size() << " inputs" << std::endl;
+		return 1;
+	}
+	int failures = 0;
+	for (size_t i = 0; i < values.size(); ++i) {
+		T x(values[i]);
+		T expected = (x > T(0)) ? sqrt_with(sqrt_algorithm::basic, x) : T(0);
+		if (results[i] != encode(expected)) {
+			std::cerr << path << ": result " << i << " of " << values[i] << " is not the encoding of " << expected << std::endl;
+			++failures;
+		}
+	}
+	return failures;
+}
+
+int main(int argc, char** argv)
+try {
+	if (argc != 2) {
+		std::cerr << "Usage: replay_trace <path to replay>" << std::endl;
+		return EXIT_FAILURE;
+	}
+	const std::string replay = argv[1];
+	const std::string directory = (std::filesystem::temp_directory_path() / ("mathfunction-replay-test-" + std::to_string(getpid()))).string();
+	std::filesystem::remove_all(directory);
+	std::filesystem::create_directories(directory);
+	int failures = 0;
+
+	// ten values over four chunks of three, two of them skipped
+	const std::vector<double> values = { 4.0, 9.0, 0.0, 16.0, 0.25, -1.0, 2.0, 100.0, 1e-3, 7.0 };
+	write_file(directory + "/trace.bin", values);
+	if (run(replay, directory, { "--trace", "trace.bin", "--algorithms", "basic", "--types", "Float,Double", "--chunk", "3", "--output-dir", "out" }) != 0) {
+		std::cerr << "replay of a double trace failed" << std::endl;
+		++failures;
+	}
+	for (const std::string type_name : { "Float", "Double" }) {
+		std::vector<std::string> row = report_row(directory, "basic", type_name);
+		if (row.empty() || row[2] != "8" || row[3] != "2" || row[4] != "0" || !(std::stod(row[5]) <= 0.5)) {
+			std::cerr << type_name << ": unexpected report row" << std::endl;
+			++failures;
+		}
+	}
+	failures += verify_output<Float>(directory + "/out/basic_Float.bin", values);
+	failures += verify_output<Double>(directory + "/out/basic_Double.bin", values);
+
+	// the same values as raw Double encodings replay to the same results, in other chunks too
+	std::vector<uint64_t> encodings;
+	for (double x : values) encodings.push_back(encode(x));
+	write_file(directory + "/raw.bin", encodings);
+	if (run(replay, directory, { "--trace", "raw.bin", "--format", "Double", "--algorithms", "basic", "--chunk", "4", "--output-dir", "raw" }) != 0
+	    || read_file<uint64_t>(directory + "/raw/basic_Double.bin") != read_file<uint64_t>(directory + "/out/basic_Double.bin")) {
+		std::cerr << "replay of a raw Double trace differs" << std::endl;
+		++failures;
+	}
+
+	// a trace cut inside an element, a missing option value and an unknown option are errors
+	write_file(directory + "/cut.bin", values, 3);
+	if (run(replay, directory, { "--trace", "cut.bin" }) == 0) ++failures;
+	if (run(replay, directory, { "--trace", "trace.bin", "--chunk" }) == 0) ++failures;
+	if (run(replay, directory, { "--trace", "trace.bin", "--threads", "2" }) == 0) ++failures;
+
+	std::filesystem::remove_all(directory);
+	std::cout << "replay_trace: " << (failures == 0 ? "PASS" : "FAIL") << std::endl;
+	return (failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+catch (const char* msg) {
+	std::cerr << msg << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const sw::universal::universal_arithmetic_exception& err) {
+	std::cerr << "Unprocessed universal arithmetic exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const sw::universal::universal_internal_exception& err) {
+	std::cerr << "Unprocessed universal internal exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (...) {
+	std::cerr << "Caught unknown exception" << std::endl;
+	return EXIT_FAILURE;
+}
@@ -0,0 +1,180 @@
+// sqrt_server.cpp: a running sqrt_server answers a valid request, rejects oversized ones without losing the connection,
+// and answers EDOM only to the client whose input was rejected
+//
+//   service_sqrt_server <path to sqrt_server>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <mathfunction/sqrt_service.hpp>
+
+// Connect to the server at path, waiting for it to come up; -1 when it never does
+int connect_to(const std::string& path) {
+	sockaddr_un address{};
+	address.sun_family = AF_UNIX;
+	std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+	for (int attempt = 0; attempt < 100; ++attempt) {
+		int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+		if (fd >= 0 && connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0) return fd;
+		if (fd >= 0) close(fd);
+		std::this_thread::sleep_for(std::chrono::milliseconds(50));
+	}
+	return -1;
+}
+
+sqrt_service_request make_header(int type, uint64_t count) {
+	sqrt_service_request header{};
+	header.magic = sqrt_service_magic;
+	header.type = static_cast<uint8_t>(type);
+	header.algorithm = static_cast<uint8_t>(sqrt_algorithm::basic);
+	header.count = count;
+	return header;
+}
+
+// Four inline doubles with exact roots come back as those roots
+int verify_valid(int fd, int type) {
+	const std::vector<double> inputs = { 4.0, 9.0, 16.0, 0.25 }, roots = { 2.0, 3.0, 4.0, 0.5 };
+	std::vector<uint64_t> in, out(inputs.size());
+	for (double x : inputs) in.push_back(encode(x));
+	sqrt_service_request header = make_header(type, in.size());
+	sqrt_service_response response{};
+	if (!write_all(fd, &header, sizeof(header)) || !write_all(fd, in.data(), in.size() * sizeof(uint64_t))
+	    || !read_all(fd, &response, sizeof(response)) || !read_all(fd, out.data(), out.size() * sizeof(uint64_t))) {
+		std::cerr << "valid request: connection lost" << std::endl;
+		return 1;
+	}
+	int failures = (response.magic == sqrt_service_magic && response.status == 0 && response.count == in.size()) ? 0 : 1;
+	for (size_t i = 0; i < roots.size(); ++i) {
+		if (out[i] != encode(roots[i])) ++failures;
+	}
+	if (failures) std::cerr << "valid request: status " << response.status << ", " << failures << " wrong results" << std::endl;
+	return failures;
+}
+
+// Status of an inline request of doubles, -1 when the connection was lost
+int request_status(int fd, int type, sqrt_algorithm algorithm, const std::vector<double>& inputs) {
+	std::vector<uint64_t> in, out(inputs.size());
+	for (double x : inputs) in.push_back(encode(x));
+	sqrt_service_request header = make_header(type, in.size());
+	header.algorithm = static_cast<uint8_t>(algorithm);
+	sqrt_service_response response{};
+	if (!write_all(fd, &header, sizeof(header)) || !write_all(fd, in.data(), in.size() * sizeof(uint64_t))
+	    || !read_all(fd, &response, sizeof(response)) || !read_all(fd, out.data(), out.size() * sizeof(uint64_t))) {
+		return -1;
+	}
+	return response.status;
+}
+
+// A header alone, answered with EINVAL and no payload
+int verify_rejected(int fd, const sqrt_service_request& header, const std::string& what) {
+	sqrt_service_response response{};
+	if (!write_all(fd, &header, sizeof(header)) || !read_all(fd, &response, sizeof(response))) {
+		std::cerr << what << ": connection lost" << std::endl;
+		return 1;
+	}
+	if (response.status != EINVAL) {
+		std::cerr << what << ": status " << response.status << ", expected EINVAL" << std::endl;
+		return 1;
+	}
+	return 0;
+}
+
+int main(int argc, char** argv)
+try {
+	if (argc != 2) {
+		std::cerr << "Usage: service_sqrt_server <path to sqrt_server>" << std::endl;
+		return EXIT_FAILURE;
+	}
+	const std::string path = "/tmp/mathfunction-sqrt-test-" + std::to_string(getpid()) + ".sock";
+	pid_t server = fork();
+	if (server < 0) throw std::runtime_error("fork failed");
+	if (server == 0) {
+		execl(argv[1], argv[1], "--socket", path.c_str(), "--window-us", "20000", static_cast<char*>(nullptr));
+		_exit(127);
+	}
+
+	int failures = 0;
+	int fd = connect_to(path);
+	if (fd < 0) {
+		std::cerr << "sqrt_server did not come up on " << path << std::endl;
+		++failures;
+	} else {
+		const int type = parse_sqrt_service_type("Double");
+		failures += verify_valid(fd, type);
+
+		// counts whose payload would wrap around size_t, or exceed the inline limit
+		failures += verify_rejected(fd, make_header(type, uint64_t(1) << 61), "wrapping inline count");
+		failures += verify_rejected(fd, make_header(type, sqrt_service_inline_limit / sizeof(uint64_t) + 1), "oversized inline count");
+
+		// a small shared object, and a count whose inputs and results wrap around to fit in it
+		sqrt_service_request shared = make_header(type, (uint64_t(1) << 60) + 1);
+		shared.shared = 1;
+		std::snprintf(shared.shm_name, sizeof(shared.shm_name), "/mathfunction-sqrt-test-%d", static_cast<int>(getpid()));
+		int shm = shm_open(shared.shm_name, O_CREAT | O_RDWR | O_TRUNC, 0600);
+		if (shm < 0 || ftruncate(shm, 64) < 0) throw std::runtime_error("shm_open: " + std::string(strerror(errno)));
+		close(shm);
+		failures += verify_rejected(fd, shared, "oversized shared count");
+		shm_unlink(shared.shm_name);
+
+		// the connection still serves requests
+		failures += verify_valid(fd, type);
+		close(fd);
+
+		// a negative input among concurrent good requests, batched together
+		// in the window: only its own client sees EDOM
+		const int clients = 4;
+		std::vector<int> fds, statuses(clients, -1);
+		for (int c = 0; c < clients; ++c) fds.push_back(connect_to(path));
+		std::vector<std::thread> threads;
+		for (int c = 0; c < clients; ++c) {
+			threads.emplace_back([&, c]() {
+				const std::vector<double> inputs = (c == 0) ? std::vector<double>{ 4.0, -1.0 } : std::vector<double>{ 4.0, 9.0, 16.0, 0.25 };
+				if (fds[c] >= 0) statuses[c] = request_status(fds[c], type, sqrt_algorithm::cordic, inputs);
+			});
+		}
+		for (auto& t : threads) t.join();
+		for (int c = 0; c < clients; ++c) {
+			const int expected = (c == 0) ? EDOM : 0;
+			if (statuses[c] != expected) {
+				std::cerr << "concurrent client " << c << ": status " << statuses[c] << ", expected " << expected << std::endl;
+				++failures;
+			}
+			if (fds[c] >= 0) close(fds[c]);
+		}
+	}
+
+	kill(server, SIGTERM);
+	waitpid(server, nullptr, 0);
+	unlink(path.c_str());
+
+	std::cout << "sqrt_server: " << (failures == 0 ? "PASS" : "FAIL") << std::endl;
+	return (failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+catch (const char* msg) {
+	std::cerr << msg << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const sw::universal::universal_arithmetic_exception& err) {
+	std::cerr << "Unprocessed universal arithmetic exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const sw::universal::universal_internal_exception& err) {
+	std::cerr << "Unprocessed universal internal exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (...) {
+	std::cerr << "Caught unknown exception" << std::endl;
+	return EXIT_FAILURE;
+}
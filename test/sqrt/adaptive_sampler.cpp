@@ -0,0 +1,129 @@
+// adaptive_sampler.cpp: refinement finds a narrow error spike within its budget, and the bands cover the range in order
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include <mathfunction/sqrt_kernels.hpp>
+#include <mathfunction/adaptive_sampler.hpp>
+
+// a flat error of a quarter ulp with a spike of 50 ulps at encoding centre
+template <typename T>
+auto spike(uint64_t centre, double scale, uint64_t& calls) {
+	return [=, &calls](const std::vector<T>& inputs, std::vector<double>& ulps) {
+		for (size_t i = 0; i < inputs.size(); ++i) {
+			double distance = std::fabs(static_cast<double>(encode(inputs[i])) - static_cast<double>(centre));
+			ulps[i] = 0.25 + 50.0 * std::exp(-distance / scale);
+		}
+		calls += inputs.size();
+	};
+}
+
+// bands in order, next to each other, from the smallest to the largest positive
+// encoding, each holding distinct encodings of its own
+template <typename T>
+bool covers(const adaptive_result& result) {
+	if (result.bands.empty() || result.bands.front().first != encode(next_up(T(0)))) return false;
+	if (result.bands.back().last != encode(std::numeric_limits<T>::max())) return false;
+	for (size_t i = 0; i < result.bands.size(); ++i) {
+		const error_band& band = result.bands[i];
+		if (band.first > band.last || (i > 0 && band.first != result.bands[i - 1].last + 1)) return false;
+		for (size_t j = 0; j < band.samples.size(); ++j) {
+			const uint64_t e = band.samples[j].encoding;
+			if (e < band.first || e > band.last || (j > 0 && e <= band.samples[j - 1].encoding)) return false;
+		}
+	}
+	return true;
+}
+
+// a spike wider than the spacing of the first samples; where the budget reaches
+// a band of single encodings, its exact maximum is found too
+template <typename T>
+int verify(uint64_t centre, double scale, const adaptive_options& options, bool reaches_encodings) {
+	int failures = 0;
+	auto check = [&](const std::string& what, bool ok) {
+		if (!ok) {
+			std::cerr << std::setw(10) << number_type_name<T>::value << " " << what << ": FAIL" << std::endl;
+			++failures;
+		}
+	};
+	uint64_t calls = 0;
+	adaptive_result result = adaptive_sweep<T>(spike<T>(centre, scale, calls), options);
+	check("covers", covers<T>(result));
+	check("budget", result.calls == calls && calls <= options.budget && calls < result.encodings);
+	check("refined", result.rounds > 0 && result.bands.size() > options.grid);
+
+	// the band of the spike is refined the furthest, and sees its top
+	const error_band* peak = nullptr;
+	unsigned depth = 0;
+	for (const auto& band : result.bands) {
+		if (centre >= band.first && centre <= band.last) peak = &band;
+		depth = std::max(depth, band.depth);
+	}
+	check("peak", peak != nullptr && peak->depth == depth && peak->max_ulp() > 50.0);
+	if (reaches_encodings) check("exact peak", peak != nullptr && peak->exhaustive && peak->max_ulp() == 50.25 && peak->worst()->encoding == centre);
+	error_stats stats = result.stats<T>();
+	check("stats", stats.count == calls && stats.max_ulp == peak->max_ulp() && stats.failures == 0);
+
+	// the same bands and samples from the same seed
+	uint64_t again = 0;
+	adaptive_result repeat = adaptive_sweep<T>(spike<T>(centre, scale, again), options);
+	bool same = repeat.bands.size() == result.bands.size();
+	for (size_t i = 0; same && i < result.bands.size(); ++i) {
+		same = repeat.bands[i].first == result.bands[i].first && repeat.bands[i].samples.size() == result.bands[i].samples.size();
+	}
+	check("deterministic", same && again == calls);
+	return failures;
+}
+
+int main(int argc, char** argv)
+try {
+	int failures = 0;
+
+	adaptive_options options;
+	options.budget = 8192;
+	options.grid = 32;
+	options.samples = 16;
+	failures += verify<Fixpnt16>(0x1234, 40.0, options, true);
+	failures += verify<Double>(encode(Double(3.0)), 1.0e16, options, false);
+
+	// a flat error below the thresholds is not refined
+	uint64_t calls = 0;
+	adaptive_result flat = adaptive_sweep<Float>([&](const std::vector<Float>& inputs, std::vector<double>& ulps) {
+		for (auto& u : ulps) u = 0.5;
+		calls += inputs.size();
+	}, options);
+	if (flat.rounds != 0 || flat.bands.size() != options.grid || calls != options.grid * options.samples) ++failures;
+
+	// a budget below the first grid cuts fewer bands, one call each
+	adaptive_options thin = options;
+	thin.budget = 10;
+	calls = 0;
+	adaptive_result small = adaptive_sweep<Float>(spike<Float>(encode(Float(3.0f)), 1.0e6, calls), thin);
+	if (!covers<Float>(small) || calls != thin.budget || small.bands.size() != thin.budget) ++failures;
+
+	// a kernel that throws leaves failures rather than errors
+	adaptive_result thrown = adaptive_sweep_kernel<Fixpnt16>([](const Fixpnt16&) -> Fixpnt16 { throw std::runtime_error("no root"); }, options);
+	if (thrown.stats<Fixpnt16>().failures != thrown.calls || thrown.stats<Fixpnt16>().count != 0) ++failures;
+
+	std::cout << "adaptive_sampler: " << (failures == 0 ? "PASS" : "FAIL") << std::endl;
+	return (failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+catch (const char* msg) {
+	std::cerr << msg << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const sw::universal::universal_arithmetic_exception& err) {
+	std::cerr << "Unprocessed universal arithmetic exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const sw::universal::universal_internal_exception& err) {
+	std::cerr << "Unprocessed universal internal exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (...) {
+	std::cerr << "Caught unknown exception" << std::endl;
+	return EXIT_FAILURE;
+}
@@ -0,0 +1,53 @@
+// edecimal_sqrt.cpp: integer square roots of edecimals, precision doubling against fixed Newton
+#include <iostream>
+#include <iomanip>
+#include <string>
+
+#include <mathfunction/edecimal_sqrt.hpp>
+
+int main(int argc, char** argv)
+try {
+	using namespace sw::universal;
+	int failures = 0;
+
+	// floor(sqrt(n)) brackets n and both methods agree
+	for (const char* digits : { "0", "1", "2", "99", "100", "99999999", "100000000", "123456789012345678901234567890",
+	                            "98765432109876543210987654321098765432109876543210987654321" }) {
+		edecimal n, one;
+		n = digits;
+		one = 1;
+		edecimal root = edecimalSqrt(n);
+		if (root * root > n || (root + one) * (root + one) <= n || root != fixedNewtonSqrt(n)) {
+			std::cerr << "edecimalSqrt(" << n << ") = " << root << " is not the floor of the root" << std::endl;
+			++failures;
+		}
+	}
+
+	// sqrt(2) to 60 decimals
+	const std::string sqrt2 = "1.414213562373095048801688724209698078569671875376948073176679";
+	edecimal two;
+	two = 2;
+	if (edecimal_sqrt_digits(two, 60) != sqrt2) {
+		std::cerr << "sqrt(2) = " << edecimal_sqrt_digits(two, 60) << " expected " << sqrt2 << std::endl;
+		++failures;
+	}
+
+	std::cout << "edecimalSqrt: " << (failures == 0 ? "PASS" : "FAIL") << std::endl;
+	return (failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+catch (const char* msg) {
+	std::cerr << msg << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const sw::universal::universal_arithmetic_exception& err) {
+	std::cerr << "Unprocessed universal arithmetic exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const sw::universal::universal_internal_exception& err) {
+	std::cerr << "Unprocessed universal internal exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (...) {
+	std::cerr << "Caught unknown exception" << std::endl;
+	return EXIT_FAILURE;
+}
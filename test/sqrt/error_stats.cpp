@@ -0,0 +1,102 @@
+// error_stats.cpp: merged partial statistics match one sequential pass
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <mathfunction/error_stats.hpp>
+#include <mathfunction/ulp.hpp>
+
+// ULP errors shaped like a kernel's: mostly below one ulp, with a long tail
+std::vector<double> sample_errors(size_t n) {
+	std::mt19937_64 rng(0x5eed);
+	std::uniform_real_distribution<double> body(0.0, 0.75);
+	std::exponential_distribution<double> tail(0.05);
+	std::vector<double> errors;
+	for (size_t i = 0; i < n; ++i) errors.push_back(i % 97 == 0 ? 1.0 + tail(rng) : body(rng));
+	return errors;
+}
+
+int report(const std::string& what, double value, double expected, double tolerance) {
+	if (std::abs(value - expected) <= tolerance) return 0;
+	std::cerr << std::setw(24) << what << ": " << value << " expected " << expected << " within " << tolerance << std::endl;
+	return 1;
+}
+
+int main(int argc, char** argv)
+try {
+	int failures = 0;
+	const size_t n = 200000;
+	std::vector<double> errors = sample_errors(n);
+
+	error_stats sequential;
+	for (size_t i = 0; i < n; ++i) sequential.add(errors[i], static_cast<double>(i));
+
+	// uneven chunks merged in order, as the parallel sweeps do
+	error_stats merged;
+	for (size_t first = 0, chunk = 1; first < n; first += chunk, chunk = chunk * 3 + 1) {
+		error_stats partial;
+		for (size_t i = first; i < std::min(n, first + chunk); ++i) partial.add(errors[i], static_cast<double>(i));
+		merged.merge(partial);
+	}
+
+	if (merged.count != sequential.count) ++failures;
+	failures += report("max ulp", merged.max_ulp, sequential.max_ulp, 0.0);
+	failures += report("max ulp argument", merged.max_ulp_argument, sequential.max_ulp_argument, 0.0);
+	failures += report("mean", merged.mean, sequential.mean, 1e-12);
+	failures += report("variance", merged.variance(), sequential.variance(), 1e-9 * sequential.variance());
+	for (size_t b = 0; b < ulp_histogram::bucket_count; ++b) {
+		if (merged.histogram.count(b) != sequential.histogram.count(b)) ++failures;
+	}
+
+	// quantiles against the sorted samples, within a rank tolerance
+	std::vector<double> sorted = errors;
+	std::sort(sorted.begin(), sorted.end());
+	for (double q : { 0.01, 0.1, 0.5, 0.9, 0.99, 0.999 }) {
+		double tolerance = (q > 0.98 ? 0.002 : 0.01);
+		double lower = sorted[static_cast<size_t>(std::max(0.0, q - tolerance) * (n - 1))];
+		double upper = sorted[static_cast<size_t>(std::min(1.0, q + tolerance) * (n - 1))];
+		for (const error_stats* s : { &sequential, &merged }) {
+			double v = s->quantile(q);
+			if (v < lower || v > upper) {
+				std::cerr << std::setw(24) << "quantile " << q << ": " << v << " outside [" << lower << ", " << upper << "]" << std::endl;
+				++failures;
+			}
+		}
+	}
+	failures += report("quantile 1", merged.quantile(1.0), sorted.back(), 0.0);
+
+	// bounded memory however many samples went in
+	if (merged.digest.centroid_count() > 200) ++failures;
+	failures += report("within half ulp", merged.within_half_ulp(),
+		double(std::count_if(errors.begin(), errors.end(), [](double e) { return e <= 0.5; })) / n, 0.0);
+
+	// an infinite error lands in the overflow bucket and keeps the maximum infinite
+	error_stats infinite;
+	infinite.add(0.25, 1.0);
+	infinite.add(INFINITY, 2.0);
+	if (infinite.histogram.count(ulp_histogram::bucket_count - 1) != 1 || !std::isinf(infinite.quantile(1.0))) ++failures;
+	if (ulp_histogram::bucket_index(1.5) != 4 || ulp_histogram::bucket_index(std::exp2(0.25)) != 2) ++failures;
+
+	std::cout << "error_stats: " << (failures == 0 ? "PASS" : "FAIL") << std::endl;
+	return (failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+catch (const char* msg) {
+	std::cerr << msg << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const sw::universal::universal_arithmetic_exception& err) {
+	std::cerr << "Unprocessed universal arithmetic exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const sw::universal::universal_internal_exception& err) {
+	std::cerr << "Unprocessed universal internal exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (...) {
+	std::cerr << "Caught unknown exception" << std::endl;
+	return EXIT_FAILURE;
+}
@@ -0,0 +1,150 @@
+// exact_residual.cpp: the exact-residual finisher rounds sqrt correctly, heron and bakhshali return rounded roots,
+// and so does the reference root near ties
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <mathfunction/sqrt_kernels.hpp>
+#include <mathfunction/encoding.hpp>
+#include <mathfunction/exact_residual.hpp>
+
+// y moved k ulps away from the root
+template <typename T>
+T nudge(T y, int k) {
+	for (; k > 0; --k) y = next_up(y);
+	for (; k < 0; ++k) y = next_down(y);
+	return y;
+}
+
+// finisher and check against the reference root on every input, and the kernels that use the finisher
+template <typename T>
+int verify(const std::vector<T>& inputs, const std::vector<T>& reference) {
+	int failures = 0;
+	const std::string type_name = number_type_name<T>::value;
+	for (size_t i = 0; i < inputs.size(); ++i) {
+		const T x = inputs[i], y = reference[i];
+		bool ok = is_correctly_rounded_sqrt(x, y) && !is_correctly_rounded_sqrt(x, next_up(y));
+		if (next_down(y) > T(0)) ok = ok && !is_correctly_rounded_sqrt(x, next_down(y));
+		for (int k : { -3, -1, 1, 3 }) {
+			T start = nudge(y, k);
+			if (start > T(0)) ok = ok && round_sqrt(x, start) == y;
+		}
+		ok = ok && heronSqrt(x) == y && bakhshaliSqrt(x) == y;
+		if (!ok) {
+			if (failures < 5) {
+				std::cerr << std::setw(10) << type_name << ": sqrt(" << x << ") = " << y << ", finisher from y+1 " << round_sqrt(x, next_up(y))
+				          << ", heron " << heronSqrt(x) << ", bakhshali " << bakhshaliSqrt(x) << std::endl;
+			}
+			++failures;
+		}
+	}
+	return failures;
+}
+
+int main(int argc, char** argv)
+try {
+	int failures = 0;
+
+	// 16-bit types over every positive encoding; the long double reference is exact for them
+	{
+		std::vector<Posit16> inputs, reference;
+		for (uint32_t bits = 1; bits < 0x8000u; ++bits) {
+			Posit16 x = decode<Posit16>(static_cast<uint16_t>(bits));
+			if (!(x > Posit16(0))) continue;
+			inputs.push_back(x);
+			reference.push_back(correctly_rounded_sqrt(x));
+		}
+		failures += verify(inputs, reference);
+	}
+	{
+		std::vector<Fixpnt16> inputs, reference;
+		for (uint32_t bits = 1; bits < 0x8000u; ++bits) {
+			Fixpnt16 x = decode<Fixpnt16>(static_cast<uint16_t>(bits));
+			inputs.push_back(x);
+			reference.push_back(correctly_rounded_sqrt(x));
+		}
+		failures += verify(inputs, reference);
+	}
+
+	// IEEE types on random encodings, subnormals and the ends of the range included; the hardware root is the reference
+	std::mt19937_64 rng(0x5eed);
+	{
+		std::vector<Float> inputs = { std::numeric_limits<float>::denorm_min(), std::numeric_limits<float>::min(), std::numeric_limits<float>::max(), 2.0f };
+		for (int i = 0; i < 20000; ++i) {
+			uint32_t bits = static_cast<uint32_t>(rng()) & 0x7f7fffffu;
+			float x;
+			std::memcpy(&x, &bits, sizeof x);
+			if (x > 0.0f) inputs.push_back(x);
+		}
+		std::vector<Float> reference;
+		for (float x : inputs) reference.push_back(std::sqrt(x));
+		failures += verify(inputs, reference);
+	}
+	{
+		std::vector<Double> inputs = { std::numeric_limits<double>::denorm_min(), std::numeric_limits<double>::min(), std::numeric_limits<double>::max(), 2.0 };
+		for (int i = 0; i < 20000; ++i) {
+			uint64_t bits = rng() & 0x7fefffffffffffffull;
+			double x;
+			std::memcpy(&x, &bits, sizeof x);
+			if (x > 0.0) inputs.push_back(x);
+		}
+		std::vector<Double> reference;
+		for (double x : inputs) reference.push_back(std::sqrt(x));
+		failures += verify(inputs, reference);
+	}
+
+	// Posit32 and Double where the root is near a tie: squares of the midpoints of
+	// neighbours, rounded to the type, whose long double root reaches the type through
+	// double and so rounds twice; correctly_rounded_sqrt has to settle those
+	{
+		std::vector<Posit32> inputs, reference;
+		for (int i = 0; i < 20000; ++i) {
+			Posit32 y = decode<Posit32>(static_cast<uint32_t>(0x30000000u + rng() % 0x20000000u));
+			long double mid = (static_cast<long double>(y) + static_cast<long double>(next_up(y))) / 2;
+			Posit32 x(static_cast<double>(mid * mid));
+			if (!(x > Posit32(0))) continue;
+			inputs.push_back(x);
+			reference.push_back(correctly_rounded_sqrt(x));
+		}
+		failures += verify(inputs, reference);
+	}
+	{
+		int wrong = 0;
+		for (int i = 0; i < 20000; ++i) {
+			double y = std::ldexp(1.0 + static_cast<double>(rng() >> 12) * 0x1p-52, static_cast<int>(rng() % 200) - 100);
+			long double mid = (static_cast<long double>(y) + static_cast<long double>(std::nextafter(y, INFINITY))) / 2;
+			for (double x : { static_cast<double>(mid * mid), std::nextafter(static_cast<double>(mid * mid), 0.0), std::nextafter(static_cast<double>(mid * mid), INFINITY) }) {
+				if (correctly_rounded_sqrt(x) != std::sqrt(x)) ++wrong;
+			}
+		}
+		if (wrong) std::cerr << "    Double: " << wrong << " reference roots differ from the hardware root near ties" << std::endl;
+		failures += wrong;
+	}
+
+	// outside the domain the root is left to the kernel
+	if (round_sqrt(-4.0, 2.0) != 2.0 || !std::isnan(round_sqrt(std::nan(""), std::nan(""))) || round_sqrt(0.0, 0.0) != 0.0) ++failures;
+	if (!is_correctly_rounded_sqrt(0.0f, 0.0f) || is_correctly_rounded_sqrt(-1.0f, 1.0f)) ++failures;
+
+	std::cout << "exact_residual: " << (failures == 0 ? "PASS" : "FAIL") << std::endl;
+	return (failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+catch (const char* msg) {
+	std::cerr << msg << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const sw::universal::universal_arithmetic_exception& err) {
+	std::cerr << "Unprocessed universal arithmetic exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const sw::universal::universal_internal_exception& err) {
+	std::cerr << "Unprocessed universal internal exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (...) {
+	std::cerr << "Caught unknown exception" << std::endl;
+	return EXIT_FAILURE;
+}
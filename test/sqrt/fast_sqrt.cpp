@@ -0,0 +1,75 @@
+// fast_sqrt.cpp: fast_sqrt dispatches to the tabled kernel of each exponent bucket
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+#include <string>
+
+#include <mathfunction/fast_sqrt.hpp>
+#include <mathfunction/ulp.hpp>
+
+// Sweep x = 2^(e/4) over the table and compare with the tabled kernel called directly;
+// the tables come from samples, so accuracy is checked against a margin over max_ulp
+template <typename T>
+int verify_fast_sqrt(int minExponent, int maxExponent) {
+	const std::string type_name = number_type_name<T>::value;
+	int failures = 0;
+	for (int e = 4 * minExponent; e <= 4 * maxExponent; ++e) {
+		T x(std::pow(2.0, e / 4.0));
+		if (!(x > T(0))) continue;
+		std::string algorithm = sqrt_algorithm_name(sqrt_dispatch<T>::kernel[sqrt_dispatch_bucket(x)]);
+		T result = fast_sqrt(x);
+		for_each_kernel([&](auto kernel) {
+			if (algorithm == kernel.name && !(kernel(x) == result)) {
+				std::cerr << std::setw(10) << type_name << ": fast_sqrt(" << static_cast<double>(x) << ") = " << static_cast<double>(result)
+					<< " differs from " << algorithm << std::endl;
+				++failures;
+			}
+		});
+		double ulp = ulp_error(result, x);
+		if (ulp > 4.0 * sqrt_dispatch<T>::max_ulp) {
+			std::cerr << std::setw(10) << type_name << ": fast_sqrt(" << static_cast<double>(x) << ") = " << static_cast<double>(result)
+				<< " is " << ulp << " ulp off using " << algorithm << std::endl;
+			++failures;
+		}
+	}
+	return failures;
+}
+
+int main(int argc, char** argv)
+try {
+	int failures = 0;
+	failures += verify_fast_sqrt<Posit16>(-8, 8);
+	failures += verify_fast_sqrt<Posit32>(-16, 16);
+	failures += verify_fast_sqrt<Fixpnt16>(-8, 6);
+	failures += verify_fast_sqrt<float>(-149, 127);
+	failures += verify_fast_sqrt<double>(-1074, 1023);
+
+	// every exponent lands in a bucket of the table
+	if (sqrt_dispatch_bucket(std::numeric_limits<double>::denorm_min()) != 0) ++failures;
+	if (sqrt_dispatch_bucket(std::numeric_limits<double>::max()) != sqrt_dispatch<double>::buckets - 1) ++failures;
+
+	// zero maps to zero, negative arguments are rejected
+	if (fast_sqrt(0.0) != 0.0) ++failures;
+	bool thrown = false;
+	try { fast_sqrt(-1.0); } catch (const std::runtime_error&) { thrown = true; }
+	if (!thrown) ++failures;
+
+	std::cout << "fast_sqrt: " << (failures == 0 ? "PASS" : "FAIL") << std::endl;
+	return (failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+catch (const char* msg) {
+	std::cerr << msg << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const sw::universal::universal_arithmetic_exception& err) {
+	std::cerr << "Unprocessed universal arithmetic exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const sw::universal::universal_internal_exception& err) {
+	std::cerr << "Unprocessed universal internal exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (...) {
+	std::cerr << "Caught unknown exception" << std::endl;
+	return EXIT_FAILURE;
+}
@@ -0,0 +1,103 @@
+// goldschmidt.cpp: ulp error of the Goldschmidt sqrt and rsqrt per type, and batch results equal to the scalar ones bit for bit
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include <mathfunction/sqrt_kernels.hpp>
+#include <mathfunction/goldschmidt.hpp>
+#include <mathfunction/input_generator.hpp>
+#include <mathfunction/encoding.hpp>
+#include <mathfunction/ulp.hpp>
+
+// log-uniform inputs on [lo, hi], zeros among them for the scalar path of the batch kernel
+template <typename T>
+int verify(double lo, double hi, double max_sqrt_ulp, double max_rsqrt_rel) {
+	int failures = 0;
+	const std::string type_name = number_type_name<T>::value;
+	input_options options;
+	options.lo = lo;
+	options.hi = hi;
+	options.samples = 20001;
+	std::vector<T> inputs = make_input_generator<T>("log_uniform", options)->generate();
+	for (size_t i = 0; i < inputs.size(); i += 997) inputs[i] = T(0);
+
+	double worst_sqrt = 0.0, worst_rsqrt = 0.0;
+	std::vector<T> scalar(inputs.size()), batch(inputs.size());
+	for (size_t i = 0; i < inputs.size(); ++i) {
+		const T x = inputs[i];
+		T sqrtS, rsqrtS;
+		goldschmidtSqrtRsqrt(x, sqrtS, rsqrtS);
+		scalar[i] = goldschmidtSqrt(x);
+		if (encode(sqrtS) != encode(scalar[i]) || encode(goldschmidtRsqrt(x)) != encode(rsqrtS)) ++failures;
+		if (!(x > T(0))) {
+			if (!(sqrtS == T(0) && rsqrtS == T(0))) ++failures;
+			continue;
+		}
+		worst_sqrt = std::max(worst_sqrt, ulp_error(sqrtS, x));
+		long double reference = 1.0L / std::sqrt(static_cast<long double>(x));
+		worst_rsqrt = std::max(worst_rsqrt, static_cast<double>(std::fabs(static_cast<long double>(rsqrtS) - reference) / reference));
+	}
+	if (worst_sqrt > max_sqrt_ulp || worst_rsqrt > max_rsqrt_rel) {
+		std::cerr << std::setw(10) << type_name << ": sqrt within " << worst_sqrt << " ulp, expected " << max_sqrt_ulp
+		          << "; rsqrt within " << worst_rsqrt << " relative, expected " << max_rsqrt_rel << std::endl;
+		++failures;
+	}
+
+	// every length, so that each tail of the 4-lane groups is covered too
+	for (size_t n : { size_t(0), size_t(1), size_t(3), size_t(4), size_t(7), inputs.size() }) {
+		std::fill(batch.begin(), batch.end(), T(-1));
+		goldschmidtSqrt(inputs.data(), batch.data(), n);
+		for (size_t i = 0; i < n; ++i) {
+			if (encode(batch[i]) != encode(scalar[i])) {
+				if (failures < 5) std::cerr << std::setw(10) << type_name << ": batch sqrt(" << inputs[i] << ") = " << batch[i] << ", scalar " << scalar[i] << std::endl;
+				++failures;
+			}
+		}
+		if (n < inputs.size() && batch[n] != T(-1)) ++failures;
+	}
+	return failures;
+}
+
+int main(int argc, char** argv)
+try {
+	int failures = 0;
+
+	// the iteration is not rounded correctly: a few ulps, more for fixpnt, whose
+	// products lose the bits below 2^-8 and whose rsqrt of large inputs has few bits
+	failures += verify<Posit16>(1e-6, 1e6, 1.5, std::ldexp(1.0, -10));
+	failures += verify<Posit32>(1e-9, 1e9, 2.0, std::ldexp(1.0, -26));
+	failures += verify<Fixpnt16>(0.0625, 100.0, 16.0, 0.05);
+	failures += verify<Float>(1e-30, 1e30, 2.0, std::ldexp(1.0, -22));
+	failures += verify<Double>(1e-300, 1e300, 2.5, std::ldexp(1.0, -51));
+
+	// negative inputs are rejected, in the batch too
+	bool thrown = false;
+	try { goldschmidtSqrt(-1.0); } catch (const std::domain_error&) { thrown = true; }
+	if (!thrown) ++failures;
+	thrown = false;
+	std::vector<double> in = { 1.0, 4.0, -9.0, 16.0 }, out(4);
+	try { goldschmidtSqrt(in.data(), out.data(), in.size()); } catch (const std::domain_error&) { thrown = true; }
+	if (!thrown) ++failures;
+
+	std::cout << "goldschmidt: " << (failures == 0 ? "PASS" : "FAIL") << std::endl;
+	return (failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+catch (const char* msg) {
+	std::cerr << msg << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const sw::universal::universal_arithmetic_exception& err) {
+	std::cerr << "Unprocessed universal arithmetic exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const sw::universal::universal_internal_exception& err) {
+	std::cerr << "Unprocessed universal internal exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (...) {
+	std::cerr << "Caught unknown exception" << std::endl;
+	return EXIT_FAILURE;
+}
@@ -0,0 +1,81 @@
+// hyperbolic_cordic.cpp: the shift-add engine rounds sqrt, ln, exp and atanh to within half an ulp
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+#include <string>
+
+#include <mathfunction/hyperbolic_cordic.hpp>
+
+// Every value of fixpnt<nbits, rbits> in [lo, hi] in steps of stride ulps; results the format
+// cannot hold are not checked. The engine carries guard bits, so a small margin over half an ulp
+template <unsigned nbits, unsigned rbits, typename Function>
+int verify_function(const std::string& name, double lo, double hi, int stride, Function f, double (*reference)(double)) {
+	using T = sw::universal::fixpnt<nbits, rbits>;
+	const double ulp = std::ldexp(1.0, -static_cast<int>(rbits));
+	const double range = std::ldexp(1.0, static_cast<int>(nbits - rbits - 1)) - ulp;
+	int failures = 0;
+	for (double v = lo; v <= hi; v += stride * ulp) {
+		T x(v);
+		double exact = reference(static_cast<double>(x));
+		if (!(std::abs(exact) < range)) continue;
+		double result = static_cast<double>(f(x));
+		if (std::abs(result - exact) > 0.501 * ulp) {
+			std::cerr << "fixpnt<" << nbits << "," << rbits << "> " << std::setw(6) << name << "(" << static_cast<double>(x) << ") = " << result
+				<< " expected " << exact << std::endl;
+			if (++failures > 10) break;
+		}
+	}
+	return failures;
+}
+
+template <unsigned nbits, unsigned rbits>
+int verify_format(int stride) {
+	using T = sw::universal::fixpnt<nbits, rbits>;
+	const double ulp = std::ldexp(1.0, -static_cast<int>(rbits));
+	const double range = std::ldexp(1.0, static_cast<int>(nbits - rbits - 1)) - ulp;
+	int failures = 0;
+	failures += verify_function<nbits, rbits>("sqrt", ulp, range, stride, [](T x) { return hyperbolicCordicSqrt(x); }, [](double v) { return std::sqrt(v); });
+	failures += verify_function<nbits, rbits>("ln", ulp, range, stride, [](T x) { return hyperbolicCordicLog(x); }, [](double v) { return std::log(v); });
+	failures += verify_function<nbits, rbits>("exp", -range, std::log(range), stride, [](T x) { return hyperbolicCordicExp(x); }, [](double v) { return std::exp(v); });
+	failures += verify_function<nbits, rbits>("atanh", ulp - 1.0, 1.0 - ulp, std::max(1, stride / 256), [](T x) { return hyperbolicCordicAtanh(x); }, [](double v) { return std::atanh(v); });
+	return failures;
+}
+
+int main(int argc, char** argv)
+try {
+	int failures = 0;
+	failures += verify_format<16, 8>(1);
+	failures += verify_format<16, 12>(1);
+	failures += verify_format<12, 4>(1);
+	failures += verify_format<32, 16>(4099);
+
+	// domain errors, and exp saturating at the top of the format
+	using Fixpnt16 = sw::universal::fixpnt<16, 8>;
+	int thrown = 0;
+	try { hyperbolicCordicSqrt(Fixpnt16(-1.0)); } catch (const std::domain_error&) { ++thrown; }
+	try { hyperbolicCordicLog(Fixpnt16(0.0)); } catch (const std::domain_error&) { ++thrown; }
+	try { hyperbolicCordicAtanh(Fixpnt16(1.0)); } catch (const std::domain_error&) { ++thrown; }
+	if (thrown != 3) ++failures;
+	if (!(hyperbolicCordicSqrt(Fixpnt16(0.0)) == Fixpnt16(0.0))) ++failures;
+	if (!(hyperbolicCordicExp(Fixpnt16(100.0)) == Fixpnt16(127.99609375))) ++failures;
+	if (!(hyperbolicCordicExp(Fixpnt16(-100.0)) == Fixpnt16(0.0))) ++failures;
+
+	std::cout << "hyperbolic_cordic: " << (failures == 0 ? "PASS" : "FAIL") << std::endl;
+	return (failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+catch (const char* msg) {
+	std::cerr << msg << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const sw::universal::universal_arithmetic_exception& err) {
+	std::cerr << "Unprocessed universal arithmetic exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const sw::universal::universal_internal_exception& err) {
+	std::cerr << "Unprocessed universal internal exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (...) {
+	std::cerr << "Caught unknown exception" << std::endl;
+	return EXIT_FAILURE;
+}
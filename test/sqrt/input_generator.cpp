@@ -0,0 +1,117 @@
+// input_generator.cpp: generators are reproducible under any split and hit their targets
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <mathfunction/sqrt_kernels.hpp>
+#include <mathfunction/input_generator.hpp>
+
+// The whole sequence equals the concatenation of unevenly sized slices
+template <typename T>
+int verify_sharding(const std::string& type_name, const std::string& generator) {
+	input_options options;
+	options.samples = 5000;
+	auto inputs = make_input_generator<T>(generator, options);
+	std::vector<T> whole = inputs->generate();
+	int failures = 0;
+	for (uint64_t first = 0, count = 1; first < whole.size(); first += count, count = count * 2 + 3) {
+		std::vector<T> slice = inputs->generate(first, static_cast<size_t>(std::min<uint64_t>(count, whole.size() - first)));
+		for (size_t i = 0; i < slice.size(); ++i) {
+			if (!(encode(slice[i]) == encode(whole[first + i]))) {
+				std::cerr << std::setw(10) << type_name << ": " << generator << " element " << first + i << " differs between slices" << std::endl;
+				++failures;
+				break;
+			}
+		}
+	}
+	return failures;
+}
+
+int main(int argc, char** argv)
+try {
+	int failures = 0;
+
+	// Philox4x32-10 known answers (Random123 kat_vectors)
+	auto zero = philox4x32::block({ 0, 0, 0, 0 }, { 0, 0 });
+	if (zero != philox4x32::counter_type{ 0x6627e8d5u, 0xe169c58du, 0xbc57ac4cu, 0x9b00dbd8u }) ++failures;
+	auto ones = philox4x32::block({ 0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu }, { 0xffffffffu, 0xffffffffu });
+	if (ones != philox4x32::counter_type{ 0x408f276du, 0x41c83b0eu, 0xa20bc7c6u, 0x6d5451fdu }) ++failures;
+	if (failures > 0) std::cerr << "philox4x32: known answers differ" << std::endl;
+
+	for (const auto& generator : input_generator_names()) {
+		if (generator != "encodings") {
+			failures += verify_sharding<float>("Float", generator);
+			failures += verify_sharding<double>("Double", generator);
+		}
+		failures += verify_sharding<Fixpnt16>("Fixpnt16", generator);
+	}
+
+	// log-uniform samples stay in range
+	input_options options;
+	options.samples = 1000;
+	for (double x : make_input_generator<double>("log_uniform", options)->generate()) {
+		if (x < options.lo || x >= options.hi) ++failures;
+	}
+
+	// boundaries: the middle element of every group is the power of two, its neighbours adjacent
+	boundary_inputs<double> boundaries(options);
+	std::vector<double> b = boundaries.generate();
+	if (b.empty() || b.size() % (2 * options.radius + 1) != 0) ++failures;
+	for (size_t g = 0; g + 1 < b.size() / (2 * options.radius + 1); ++g) {
+		const double* group = &b[g * (2 * options.radius + 1)];
+		double power = group[options.radius];
+		int exponent;
+		if (std::frexp(power, &exponent) != 0.5) ++failures;
+		if (group[options.radius + 1] != std::nextafter(power, INFINITY) || group[options.radius - 1] != std::nextafter(power, 0.0)) ++failures;
+	}
+
+	// encodings: every pattern once, in order
+	encoding_inputs<float> encodings;
+	if (encodings.size() != (uint64_t(1) << 32)) ++failures;
+	std::vector<float> e = encodings.generate(0x3f800000u, 2);
+	if (e[0] != 1.0f || e[1] != std::nextafter(1.0f, 2.0f)) ++failures;
+
+	// midpoints: the exact roots of the middle elements lie far closer to a midpoint
+	// than the quarter ulp a random input averages
+	midpoint_inputs<float> midpoints(options);
+	std::vector<float> m = midpoints.generate();
+	long double distance = 0;
+	for (size_t i = 1; i < m.size(); i += 3) {
+		long double root = std::sqrt(static_cast<long double>(m[i]));
+		float below = static_cast<float>(root);
+		if (static_cast<long double>(below) > root) below = std::nextafter(below, 0.0f);
+		long double ulp = static_cast<long double>(std::nextafter(below, INFINITY)) - below;
+		distance += std::abs(root - (below + ulp / 2)) / ulp;
+	}
+	distance /= static_cast<long double>(m.size() / 3);
+	if (distance > 0.15L) {
+		std::cerr << std::setw(10) << "Float: midpoint inputs average " << static_cast<double>(distance) << " ulp from a midpoint" << std::endl;
+		++failures;
+	}
+
+	bool thrown = false;
+	try { make_input_generator<double>("gaussian"); } catch (const std::runtime_error&) { thrown = true; }
+	if (!thrown) ++failures;
+
+	std::cout << "input_generator: " << (failures == 0 ? "PASS" : "FAIL") << std::endl;
+	return (failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+catch (const char* msg) {
+	std::cerr << msg << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const sw::universal::universal_arithmetic_exception& err) {
+	std::cerr << "Unprocessed universal arithmetic exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const sw::universal::universal_internal_exception& err) {
+	std::cerr << "Unprocessed universal internal exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (...) {
+	std::cerr << "Caught unknown exception" << std::endl;
+	return EXIT_FAILURE;
+}
@@ -0,0 +1,68 @@
+// poly_sqrt.cpp: relative error of polySqrt against the double square root
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+#include <string>
+
+#include <mathfunction/poly_sqrt.hpp>
+
+// Sweep x = 2^(e/4) and count results further than maxRelError from sqrt(x)
+template <typename T>
+int verify_poly_sqrt(const std::string& type_name, int minExponent, int maxExponent, double maxRelError) {
+	int failures = 0;
+	for (int e = 4 * minExponent; e <= 4 * maxExponent; ++e) {
+		T x(std::pow(2.0, e / 4.0));
+		double reference = std::sqrt(static_cast<double>(x));
+		double result = static_cast<double>(polySqrt(x));
+		double relError = std::abs(result - reference) / reference;
+		if (relError > maxRelError) {
+			std::cerr << std::setw(10) << type_name << ": polySqrt(" << static_cast<double>(x) << ") = " << result
+				<< " expected " << reference << " relative error " << relError << std::endl;
+			++failures;
+		}
+	}
+	return failures;
+}
+
+int main(int argc, char** argv)
+try {
+	using namespace sw::universal;
+	using Posit16 = posit<16, 2>;
+	using Posit32 = posit<32, 2>;
+	using Fixpnt16 = fixpnt<16, 8>;
+
+	int failures = 0;
+	failures += verify_poly_sqrt<Posit16>("Posit16", -8, 8, std::ldexp(1.0, -10));
+	failures += verify_poly_sqrt<Posit32>("Posit32", -16, 16, std::ldexp(1.0, -22));
+	failures += verify_poly_sqrt<Fixpnt16>("Fixpnt16", 0, 6, std::ldexp(1.0, -7));
+	failures += verify_poly_sqrt<float>("Float", -120, 120, std::ldexp(1.0, -22));
+	failures += verify_poly_sqrt<double>("Double", -1000, 1000, std::ldexp(1.0, -51));
+
+	// float takes a short polynomial and one Heron step, cheaper than the widest polynomial and a step
+	static_assert(poly_sqrt_coefficients<float>::degree == 5 && poly_sqrt_refinements<float>() == 1);
+
+	// zero maps to zero, negative arguments are rejected
+	if (polySqrt(0.0) != 0.0) ++failures;
+	bool thrown = false;
+	try { polySqrt(-1.0); } catch (const std::runtime_error&) { thrown = true; }
+	if (!thrown) ++failures;
+
+	std::cout << "polySqrt: " << (failures == 0 ? "PASS" : "FAIL") << std::endl;
+	return (failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+catch (const char* msg) {
+	std::cerr << msg << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const sw::universal::universal_arithmetic_exception& err) {
+	std::cerr << "Unprocessed universal arithmetic exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const sw::universal::universal_internal_exception& err) {
+	std::cerr << "Unprocessed universal internal exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (...) {
+	std::cerr << "Caught unknown exception" << std::endl;
+	return EXIT_FAILURE;
+}
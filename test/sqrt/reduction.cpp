@@ -0,0 +1,136 @@
+// reduction.cpp: parallel reductions are bit-identical for every thread count
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+#include <atomic>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <mathfunction/sqrt_kernels.hpp>
+#include <mathfunction/reduction.hpp>
+#include <mathfunction/error_stats.hpp>
+#include <mathfunction/ulp.hpp>
+
+bool same_bits(double a, double b) {
+	return std::memcmp(&a, &b, sizeof(double)) == 0;
+}
+
+// The fixed tree over blocks [first, first + 2^level) clipped to blocks, as nested pairs
+std::string tree(size_t first, unsigned level, size_t blocks) {
+	if (level == 0) return std::to_string(first);
+	size_t half = size_t(1) << (level - 1);
+	if (first + half >= blocks) return tree(first, level - 1, blocks);
+	return "(" + tree(first, level - 1, blocks) + " " + tree(first + half, level - 1, blocks) + ")";
+}
+
+// A partial that counts how many of its kind are alive
+struct counted_partial {
+	static inline std::atomic<long> alive{ 0 };
+	static inline std::atomic<long> peak{ 0 };
+	double sum = 0.0;
+	counted_partial() { track(); }
+	counted_partial(const counted_partial& other) : sum(other.sum) { track(); }
+	counted_partial& operator=(const counted_partial&) = default;
+	~counted_partial() { --alive; }
+	static void track() {
+		long now = ++alive, seen = peak;
+		while (now > seen && !peak.compare_exchange_weak(seen, now)) {}
+	}
+};
+
+int main(int argc, char** argv)
+try {
+	int failures = 0;
+	const size_t n = 1000003;
+
+	// terms of widely different magnitudes, so the order of additions shows in the low bits
+	auto term = [](size_t i) { return std::ldexp(1.0 + double(i % 7) / 7.0, static_cast<int>(i % 61) - 30) * ((i % 3 == 0) ? -1.0 : 1.0); };
+	double reference = parallel_sum(n, term, 4096, 1);
+	for (unsigned threads : { 2u, 3u, 8u, 13u, 64u }) {
+		double sum = parallel_sum(n, term, 4096, threads);
+		if (!same_bits(sum, reference)) {
+			std::cerr << std::setw(10) << "sum on " << threads << " threads: " << std::hexfloat << sum << " differs from " << reference << std::defaultfloat << std::endl;
+			++failures;
+		}
+	}
+
+	// compensation recovers what a plain sum loses: 1 + 1e100 + 1 - 1e100
+	auto cancel = [](size_t i) { return (i % 4 == 1) ? 1e100 : (i % 4 == 3) ? -1e100 : 1.0; };
+	double compensated = parallel_sum(4000, cancel, 256, 4);
+	if (compensated != 2000.0) {
+		std::cerr << std::setw(10) << "compensated sum " << compensated << " expected 2000" << std::endl;
+		++failures;
+	}
+
+	// error statistics of a sweep reduce to the same moments on any thread count
+	auto sweep = [&](unsigned threads) {
+		return parallel_reduce(size_t(200000), size_t(1000), error_stats{},
+			[](size_t first, size_t last, error_stats& partial) {
+				for (size_t i = first; i < last; ++i) {
+					float x = 1.0f + float(i) / 1024.0f;
+					partial.add(ulp_error(goldschmidtSqrt(x), x), x);
+				}
+			},
+			[](error_stats& lhs, const error_stats& rhs) { lhs.merge(rhs); },
+			threads);
+	};
+	error_stats one = sweep(1);
+	for (unsigned threads : { 2u, 5u, 16u }) {
+		error_stats many = sweep(threads);
+		if (!same_bits(many.mean, one.mean) || !same_bits(many.m2, one.m2) || !same_bits(many.quantile(0.99), one.quantile(0.99))
+			|| many.max_ulp_argument != one.max_ulp_argument) {
+			std::cerr << std::setw(10) << "error_stats on " << threads << " threads differ from one thread" << std::endl;
+			++failures;
+		}
+	}
+
+	// the partials are combined in the same tree on every thread count, left into right
+	for (size_t blocks : { size_t(1), size_t(2), size_t(3), size_t(5), size_t(8), size_t(13), size_t(37) }) {
+		unsigned top = 0;
+		while ((size_t(1) << top) < blocks) ++top;
+		for (unsigned threads : { 1u, 3u, 8u }) {
+			std::string shape = parallel_reduce(blocks, size_t(1), std::string(),
+				[](size_t first, size_t, std::string& partial) { partial = std::to_string(first); },
+				[](std::string& lhs, const std::string& rhs) { lhs = "(" + lhs + " " + rhs + ")"; },
+				threads);
+			if (shape != tree(0, top, blocks)) {
+				std::cerr << std::setw(10) << "tree of " << blocks << " blocks on " << threads << " threads: " << shape << std::endl;
+				++failures;
+			}
+		}
+	}
+
+	// memory does not grow with the input: a few partials per thread and level, not one per block
+	const size_t blocks = 100000;
+	double total = parallel_reduce(blocks * 16, size_t(16), counted_partial{},
+		[](size_t first, size_t last, counted_partial& partial) { partial.sum += double(last - first); },
+		[](counted_partial& lhs, const counted_partial& rhs) { lhs.sum += rhs.sum; },
+		4).sum;
+	if (total != double(blocks * 16) || counted_partial::peak > 4 * 2 * 20 + 8) {
+		std::cerr << std::setw(10) << "partials alive: " << counted_partial::peak << " at most for " << blocks << " blocks" << std::endl;
+		++failures;
+	}
+
+	// empty input reduces to the identity
+	if (parallel_sum(0, term) != 0.0) ++failures;
+
+	std::cout << "reduction: " << (failures == 0 ? "PASS" : "FAIL") << std::endl;
+	return (failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+catch (const char* msg) {
+	std::cerr << msg << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const sw::universal::universal_arithmetic_exception& err) {
+	std::cerr << "Unprocessed universal arithmetic exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const sw::universal::universal_internal_exception& err) {
+	std::cerr << "Unprocessed universal internal exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (...) {
+	std::cerr << "Caught unknown exception" << std::endl;
+	return EXIT_FAILURE;
+}
@@ -0,0 +1,121 @@
+// result_cache.cpp: hits and misses across runs, merges on flush, and segments dropped when stale or malformed
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include <mathfunction/sqrt_kernels.hpp>
+#include <mathfunction/result_cache.hpp>
+
+// The basic kernel under its own name, counting the calls the cache lets through
+struct counted_sqrt {
+	const char* name = "basic";
+	size_t* calls;
+	double operator()(double x) const {
+		++*calls;
+		if (x < 0.0) throw std::domain_error("negative argument");
+		return std::sqrt(x);
+	}
+};
+
+std::vector<double> range(int first, int last) {
+	std::vector<double> values;
+	for (int i = first; i <= last; ++i) values.push_back(i);
+	return values;
+}
+
+// One run over inputs with a fresh cache on directory; false when the hits, the
+// kernel calls or the results are not the expected ones
+bool run(const std::string& directory, const std::vector<double>& inputs, uint64_t expected_hits, const std::string& what) {
+	size_t calls = 0;
+	result_cache cache(directory);
+	std::vector<double> outputs;
+	std::vector<bool> failed;
+	cache.evaluate(counted_sqrt{ "basic", &calls }, "Double", inputs, outputs, failed);
+	bool ok = cache.enabled() && cache.hits() == expected_hits && cache.misses() == inputs.size() - expected_hits && calls == cache.misses();
+	for (size_t i = 0; i < inputs.size(); ++i) {
+		ok = ok && (inputs[i] < 0.0 ? failed[i] && outputs[i] == 0.0 : !failed[i] && outputs[i] == std::sqrt(inputs[i]));
+	}
+	if (!ok) std::cerr << std::setw(24) << what << ": " << cache.hits() << " hits, " << cache.misses() << " misses, " << calls << " calls, expected "
+	                   << expected_hits << " hits" << std::endl;
+	return ok;
+}
+
+int main(int argc, char** argv)
+try {
+	int failures = 0;
+	const std::string directory = (std::filesystem::temp_directory_path() / ("mathfunction-cache-test-" + std::to_string(getpid()))).string();
+	const std::string segment = directory + "/basic-Double.seg";
+	std::filesystem::remove_all(directory);
+
+	// a cold cache misses everything, failures included; a warm one computes nothing
+	std::vector<double> lower = range(1, 100);
+	lower.push_back(-4.0);
+	if (!run(directory, lower, 0, "cold")) ++failures;
+	if (!run(directory, lower, lower.size(), "warm")) ++failures;
+
+	// an overlapping run hits the shared half, and flush merges the rest into the segment
+	if (!run(directory, range(51, 150), 50, "overlap")) ++failures;
+	std::vector<double> all = range(1, 150);
+	all.push_back(-4.0);
+	if (!run(directory, all, all.size(), "merged")) ++failures;
+
+	// a segment of another kernel version is deleted when the cache opens
+	std::ifstream in(directory + "/index.csv");
+	std::stringstream index;
+	index << in.rdbuf();
+	in.close();
+	std::string text = index.str();
+	const std::string version = kernel_version("basic");
+	if (text.find(version) == std::string::npos) ++failures;
+	else text.replace(text.find(version), version.size(), "0123456789abcdef");
+	std::ofstream(directory + "/index.csv") << text;
+	{
+		result_cache cache(directory);
+		if (std::filesystem::exists(segment)) {
+			std::cerr << "stale segment still on disk" << std::endl;
+			++failures;
+		}
+	}
+	if (!run(directory, all, 0, "after version change")) ++failures;
+
+	// a truncated segment, and ones whose header claims more entries than they hold,
+	// also a count whose size in bytes wraps around to that of ten entries, read as empty
+	std::filesystem::resize_file(segment, 4);
+	if (!run(directory, all, 0, "truncated segment")) ++failures;
+	for (uint64_t entries : { uint64_t(1) << 20, (uint64_t(1) << 61) + 10 }) {
+		if (!run(directory, all, all.size(), "rewritten segment")) ++failures;
+		{
+			std::fstream file(segment, std::ios::in | std::ios::out | std::ios::binary);
+			cache_segment_header header{ cache_segment_magic, entries };
+			file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		}
+		if (!run(directory, all, 0, "oversized header " + std::to_string(entries))) ++failures;
+	}
+
+	std::filesystem::remove_all(directory);
+	std::cout << "result_cache: " << (failures == 0 ? "PASS" : "FAIL") << std::endl;
+	return (failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+catch (const char* msg) {
+	std::cerr << msg << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const sw::universal::universal_arithmetic_exception& err) {
+	std::cerr << "Unprocessed universal arithmetic exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const sw::universal::universal_internal_exception& err) {
+	std::cerr << "Unprocessed universal internal exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (...) {
+	std::cerr << "Caught unknown exception" << std::endl;
+	return EXIT_FAILURE;
+}
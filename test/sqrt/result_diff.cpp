@@ -0,0 +1,108 @@
+// result_diff.cpp: encoding distances per type, and diffs that are the same on any thread count
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include <mathfunction/sqrt_kernels.hpp>
+#include <mathfunction/result_diff.hpp>
+
+bool same_diff(const result_diff& a, const result_diff& b) {
+	if (a.compared != b.compared || a.changed != b.changed || a.only_lhs != b.only_lhs || a.only_rhs != b.only_rhs) return false;
+	if (a.max_ulps != b.max_ulps || a.largest.position != b.largest.position || a.first.size() != b.first.size()) return false;
+	for (size_t i = 0; i < a.first.size(); ++i) {
+		if (a.first[i].position != b.first[i].position || a.first[i].ulps != b.first[i].ulps) return false;
+	}
+	for (size_t i = 0; i < ulp_histogram::bucket_count; ++i) {
+		if (a.histogram.count(i) != b.histogram.count(i)) return false;
+	}
+	return true;
+}
+
+int main(int argc, char** argv)
+try {
+	int failures = 0;
+
+	// distances count the values between two encodings, across zero and the sign
+	auto expect = [&](const std::string& what, uint64_t distance, uint64_t expected) {
+		if (distance != expected) {
+			std::cerr << std::setw(10) << what << ": distance " << distance << " expected " << expected << std::endl;
+			++failures;
+		}
+	};
+	expect("float", encoding_distance<float>(encode(1.0f), encode(std::nextafter(1.0f, 2.0f))), 1);
+	expect("float", encoding_distance<float>(encode(-0.0f), encode(0.0f)), 0);
+	expect("float", encoding_distance<float>(encode(-std::numeric_limits<float>::denorm_min()), encode(std::numeric_limits<float>::denorm_min())), 2);
+	expect("double", encoding_distance<double>(encode(-std::numeric_limits<double>::max()), encode(std::numeric_limits<double>::max())), 0xffdffffffffffffeull);
+	expect("Fixpnt16", encoding_distance<Fixpnt16>(0x7fff, 0x8000), 0xffff);
+	expect("Posit16", encoding_distance<Posit16>(0xffff, 0x0001), 2);
+	expect("Posit32", encoding_distance<Posit32>(0x40000000, 0x40000003), 3);
+
+	// positional diff: changes at known positions, some in neighbouring blocks
+	const size_t n = 3 * diff_block_elements + 12345;
+	std::vector<uint32_t> lhs(n), rhs;
+	for (size_t i = 0; i < n; ++i) lhs[i] = static_cast<uint32_t>(i * 2654435761u);
+	rhs = lhs;
+	std::vector<size_t> changed = { 7, diff_block_elements - 1, diff_block_elements, 2 * diff_block_elements + 3, n - 1 };
+	for (size_t k = 0; k < changed.size(); ++k) rhs[changed[k]] += static_cast<uint32_t>(k + 1);
+	result_diff one = diff_results<Posit32>(lhs.data(), rhs.data(), n, 3, 1);
+	if (one.compared != n || one.changed != changed.size() || one.first.size() != 3 || one.max_ulps != changed.size()) ++failures;
+	for (size_t k = 0; k < one.first.size(); ++k) {
+		if (one.first[k].position != changed[k] || one.first[k].ulps != k + 1) ++failures;
+	}
+	if (one.largest.position != n - 1 || one.histogram.count(0) != 0 || one.histogram.count(1) != 1) ++failures;
+	for (unsigned threads : { 2u, 3u, 8u }) {
+		if (!same_diff(one, diff_results<Posit32>(lhs.data(), rhs.data(), n, 3, threads))) {
+			std::cerr << std::setw(10) << "positional diff on " << threads << " threads differs from one thread" << std::endl;
+			++failures;
+		}
+	}
+
+	// joined diff: inputs missing on either side, one kernel failure, and a change across a block boundary
+	std::vector<cache_entry> a, b;
+	uint64_t missing_from_b = 0, missing_from_a = 1;
+	size_t failed_index = 0;
+	for (uint64_t input = 0; input < diff_block_elements + 1000; ++input) {
+		cache_entry e{ 2 * input, input, 0, 0 };
+		if (input % 1000 != 1) a.push_back(e); else ++missing_from_a;
+		if (input % 1000 != 2) b.push_back(e); else ++missing_from_b;
+		if (input == diff_block_elements + 17) failed_index = b.size() - 1;
+	}
+	b.push_back({ 2 * (diff_block_elements + 5000), 0, 0, 0 });
+	b[10].output += 4;
+	b[failed_index].failed = 1;
+	result_diff joined = diff_results<Double>(a.data(), a.size(), b.data(), b.size(), 10, 1);
+	if (joined.only_lhs != missing_from_b || joined.only_rhs != missing_from_a || joined.changed != 2 || joined.max_ulps != diff_failed_ulps) {
+		std::cerr << std::setw(10) << "joined diff: only " << joined.only_lhs << "/" << joined.only_rhs << ", changed " << joined.changed << std::endl;
+		++failures;
+	}
+	if (joined.first.size() != 2 || joined.first[0].input != b[10].input || joined.first[0].ulps != 4) ++failures;
+	if (joined.compared + joined.only_lhs != a.size() || joined.compared + joined.only_rhs != b.size()) ++failures;
+	for (unsigned threads : { 2u, 5u }) {
+		if (!same_diff(joined, diff_results<Double>(a.data(), a.size(), b.data(), b.size(), 10, threads))) {
+			std::cerr << std::setw(10) << "joined diff on " << threads << " threads differs from one thread" << std::endl;
+			++failures;
+		}
+	}
+	if (diff_results<Double>(a.data(), 0, b.data(), b.size(), 10).only_rhs != b.size()) ++failures;
+
+	std::cout << "result_diff: " << (failures == 0 ? "PASS" : "FAIL") << std::endl;
+	return (failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+catch (const char* msg) {
+	std::cerr << msg << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const sw::universal::universal_arithmetic_exception& err) {
+	std::cerr << "Unprocessed universal arithmetic exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const sw::universal::universal_internal_exception& err) {
+	std::cerr << "Unprocessed universal internal exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (...) {
+	std::cerr << "Caught unknown exception" << std::endl;
+	return EXIT_FAILURE;
+}
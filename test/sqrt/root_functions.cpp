@@ -0,0 +1,145 @@
+// root_functions.cpp: rsqrt, cube root and hypot on the shared range reduction, and hypot without overflow in fixpnt
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include <mathfunction/root_functions.hpp>
+
+// Relative error of f against reference at x = 2^(e/4), for e/4 in [minExponent, maxExponent]
+template <typename T, typename Function>
+int verify_relative(const std::string& type_name, const std::string& name, int minExponent, int maxExponent, double maxRelError,
+                    Function f, double (*reference)(double)) {
+	int failures = 0;
+	for (int e = 4 * minExponent; e <= 4 * maxExponent; ++e) {
+		for (double sign : { 1.0, -1.0 }) {
+			if (sign < 0 && name != "cbrt") continue;
+			T x(sign * std::pow(2.0, e / 4.0));
+			double exact = reference(static_cast<double>(x));
+			double result = static_cast<double>(f(x));
+			double relError = std::abs(result - exact) / std::abs(exact);
+			if (relError > maxRelError) {
+				std::cerr << std::setw(10) << type_name << ": " << name << "(" << static_cast<double>(x) << ") = " << result
+					<< " expected " << exact << " relative error " << relError << std::endl;
+				++failures;
+			}
+		}
+	}
+	return failures;
+}
+
+template <typename T>
+int verify_type(const std::string& type_name, int minExponent, int maxExponent, double maxRelError) {
+	int failures = 0;
+	failures += verify_relative<T>(type_name, "rsqrt", minExponent, maxExponent, maxRelError, [](T x) { return rsqrt(x); }, [](double v) { return 1.0 / std::sqrt(v); });
+	failures += verify_relative<T>(type_name, "cbrt", minExponent, maxExponent, maxRelError, [](T x) { return cube_root(x); }, [](double v) { return std::cbrt(v); });
+	// hypot of x and 3x/4 at the ends of the range, where x^2 itself would overflow or underflow
+	failures += verify_relative<T>(type_name, "hypot", minExponent, maxExponent, maxRelError, [](T x) { return safe_hypot(x, x * T(0.75)); },
+		[](double v) { return std::hypot(v, v * 0.75); });
+	return failures;
+}
+
+// Batches of every length up to 64 against the scalar functions, compared by encoding
+template <typename T>
+int verify_batch(const std::string& type_name) {
+	std::vector<T> in, other, out(64);
+	for (int i = 0; i < 64; ++i) {
+		in.push_back(T(0.37 * (i + 1)));
+		other.push_back(T(1.0 / (i + 1)));
+	}
+	int failures = 0;
+	auto expect = [&](const std::string& name, size_t n, auto scalar) {
+		for (size_t i = 0; i < n; ++i) {
+			if (encode(out[i]) != encode(scalar(i))) {
+				std::cerr << std::setw(10) << type_name << ": " << name << " batch of " << n << " differs at " << i << ": " << out[i] << " vs " << scalar(i) << std::endl;
+				++failures;
+				return;
+			}
+		}
+	};
+	for (size_t n : { size_t(1), size_t(3), size_t(4), size_t(7), in.size() }) {
+		rsqrt_batch(in.data(), out.data(), n);
+		expect("rsqrt", n, [&](size_t i) { return rsqrt(in[i]); });
+		cube_root_batch(in.data(), out.data(), n);
+		expect("cbrt", n, [&](size_t i) { return cube_root(in[i]); });
+		hypot_batch(in.data(), other.data(), out.data(), n);
+		expect("hypot", n, [&](size_t i) { return safe_hypot(in[i], other[i]); });
+	}
+	return failures;
+}
+
+// Pairs on a grid of Fixpnt16 values: hypot correctly rounded, saturated beyond the range
+int verify_fixpnt_hypot() {
+	using Fixpnt16 = sw::universal::fixpnt<16, 8>;
+	const double ulp = 1.0 / 256.0;
+	const double maxpos = 128.0 - ulp;
+	int failures = 0;
+	for (double a = -128.0; a <= maxpos; a += 0.73046875) {
+		for (double b = -128.0; b <= maxpos; b += 3.01171875) {
+			double exact = std::hypot(a, b);
+			double result = static_cast<double>(safe_hypot(Fixpnt16(a), Fixpnt16(b)));
+			double expected = std::min(exact, maxpos);
+			if (std::abs(result - expected) > 0.5 * ulp) {
+				std::cerr << std::setw(10) << "Fixpnt16: hypot(" << a << ", " << b << ") = " << result << " expected " << expected << std::endl;
+				if (++failures > 10) return failures;
+			}
+		}
+	}
+	return failures;
+}
+
+int main(int argc, char** argv)
+try {
+	using namespace sw::universal;
+	using Posit32 = posit<32, 2>;
+	using Fixpnt16 = fixpnt<16, 8>;
+
+	int failures = 0;
+	failures += verify_type<float>("Float", -120, 120, std::ldexp(1.0, -22));
+	failures += verify_type<double>("Double", -1000, 1000, std::ldexp(1.0, -50));
+	failures += verify_type<Posit32>("Posit32", -16, 16, std::ldexp(1.0, -22));
+	failures += verify_fixpnt_hypot();
+
+	// fixpnt reciprocal square roots and cube roots within a few ulps of the format
+	const double fixpnt_tolerance = 6.0 / 256.0;
+	for (double v = 1.0 / 256.0; v < 128.0; v += 0.38671875) {
+		Fixpnt16 x(v);
+		if (std::abs(static_cast<double>(cube_root(x)) - std::cbrt(v)) > fixpnt_tolerance) ++failures;
+		if (std::abs(static_cast<double>(cube_root(Fixpnt16(-v))) + std::cbrt(v)) > fixpnt_tolerance) ++failures;
+		double r = 1.0 / std::sqrt(v);
+		if (r < 128.0 && std::abs(static_cast<double>(rsqrt(x)) - r) > fixpnt_tolerance) ++failures;
+	}
+	if (std::abs(static_cast<double>(cube_root(Fixpnt16(-128.0))) + std::cbrt(128.0)) > fixpnt_tolerance) ++failures;
+
+	// batch variants agree with the scalar functions bit for bit, IEEE types included
+	failures += verify_batch<float>("Float");
+	failures += verify_batch<double>("Double");
+	failures += verify_batch<Posit32>("Posit32");
+	failures += verify_batch<Fixpnt16>("Fixpnt16");
+
+	// zero and the domain of rsqrt
+	if (cube_root(0.0) != 0.0 || safe_hypot(0.0, -0.0) != 0.0 || safe_hypot(0.0, -3.0) != 3.0) ++failures;
+	bool thrown = false;
+	try { rsqrt(0.0f); } catch (const std::domain_error&) { thrown = true; }
+	if (!thrown) ++failures;
+
+	std::cout << "root_functions: " << (failures == 0 ? "PASS" : "FAIL") << std::endl;
+	return (failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+catch (const char* msg) {
+	std::cerr << msg << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const sw::universal::universal_arithmetic_exception& err) {
+	std::cerr << "Unprocessed universal arithmetic exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const sw::universal::universal_internal_exception& err) {
+	std::cerr << "Unprocessed universal internal exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (...) {
+	std::cerr << "Caught unknown exception" << std::endl;
+	return EXIT_FAILURE;
+}
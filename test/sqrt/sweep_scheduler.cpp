@@ -0,0 +1,125 @@
+// sweep_scheduler.cpp: topology from a /sys tree, placement specs, and every block run once on any placement
+#include <iostream>
+#include <iomanip>
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include <mathfunction/sqrt_kernels.hpp>
+#include <mathfunction/sweep_scheduler.hpp>
+
+namespace fs = std::filesystem;
+
+void write_file(const fs::path& path, const std::string& line) {
+	fs::create_directories(path.parent_path());
+	std::ofstream(path) << line << "\n";
+}
+
+// two nodes of two cores with two threads each, and a node without CPUs
+fs::path fake_sys() {
+	fs::path root = fs::temp_directory_path() / ("sweep_scheduler_sys_" + std::to_string(getpid()));
+	fs::remove_all(root);
+	write_file(root / "node" / "node0" / "cpulist", "0-1,4-5");
+	write_file(root / "node" / "node0" / "distance", "10 21 31");
+	write_file(root / "node" / "node1" / "cpulist", "2-3,6-7");
+	write_file(root / "node" / "node1" / "distance", "21 10 31");
+	write_file(root / "node" / "node2" / "cpulist", "");
+	write_file(root / "node" / "possible", "0-2");
+	for (unsigned cpu = 0; cpu < 8; ++cpu) {
+		unsigned core = cpu % 4;
+		write_file(root / "cpu" / ("cpu" + std::to_string(cpu)) / "topology" / "thread_siblings_list",
+		           std::to_string(core) + "," + std::to_string(core + 4));
+	}
+	return root;
+}
+
+int main(int argc, char** argv)
+try {
+	int failures = 0;
+	auto check = [&](const std::string& what, bool ok) {
+		if (!ok) {
+			std::cerr << std::setw(10) << what << ": FAIL" << std::endl;
+			++failures;
+		}
+	};
+
+	check("cpulist", parse_cpulist("0-3,8,10-11\n") == std::vector<unsigned>{ 0, 1, 2, 3, 8, 10, 11 });
+	check("empty cpulist", parse_cpulist("").empty());
+
+	// cores before their siblings, CPUs outside the affinity mask and empty nodes left out
+	fs::path sys = fake_sys();
+	cpu_topology topology = cpu_topology::detect(sys.string(), { 0, 1, 2, 3, 4, 5, 6, 7 });
+	check("nodes", topology.nodes.size() == 2 && topology.nodes[0].id == 0 && topology.nodes[1].id == 1);
+	check("cores first", topology.nodes[0].cpus == std::vector<unsigned>{ 0, 1, 4, 5 } && topology.nodes[1].cpus == std::vector<unsigned>{ 2, 3, 6, 7 });
+	check("distance", topology.distance(0, 1) == 21 && topology.neighbours(1) == std::vector<size_t>{ 0 });
+	cpu_topology masked = cpu_topology::detect(sys.string(), { 2, 3 });
+	check("masked", masked.nodes.size() == 1 && masked.nodes[0].id == 1 && masked.cpu_count() == 2);
+	cpu_topology flat = cpu_topology::detect((sys / "missing").string(), { 0, 1, 2 });
+	check("no /sys", flat.nodes.size() == 1 && flat.cpu_count() == 3);
+	fs::remove_all(sys);
+
+	placement_options spec = placement_options::parse("cores,threads=6,nodes=1,huge-pages,local");
+	check("spec", spec.mode == placement_mode::cores && spec.threads == 6 && spec.nodes == std::vector<unsigned>{ 1 } && spec.huge_pages && !spec.cross_node);
+	check("default spec", placement_options::parse("").mode == placement_mode::nodes);
+	bool rejected = false;
+	try { placement_options::parse("sockets"); } catch (const std::invalid_argument&) { rejected = true; }
+	check("bad spec", rejected);
+	rejected = false;
+	try { sweep_scheduler(placement_options::parse("none,nodes=3"), topology); } catch (const std::invalid_argument&) { rejected = true; }
+	check("bad node", rejected);
+
+	// every block once, whichever node runs it; without crossing, each node runs just its own range
+	const size_t n = 100003, block_size = 1000, blocks = (n + block_size - 1) / block_size;
+	for (const char* placement : { "none,threads=3", "none,threads=5,local", "none,threads=1", "nodes,threads=4", "cores" }) {
+		sweep_scheduler scheduler(placement_options::parse(placement), topology);
+		std::vector<std::atomic<unsigned>> runs(blocks);
+		scheduler.for_each_block(n, block_size, [&](size_t first, size_t last, size_t b) {
+			if (first != b * block_size || last != std::min(n, first + block_size)) runs[b] += 100;
+			++runs[b];
+		});
+		bool once = true;
+		for (auto& r : runs) once = once && r == 1;
+		const placement_stats& s = scheduler.stats();
+		uint64_t local = 0, remote = 0;
+		for (size_t k = 0; k < s.local_blocks.size(); ++k) {
+			local += s.local_blocks[k];
+			remote += s.remote_blocks[k];
+		}
+		check(std::string(placement) + " once", once);
+		check(std::string(placement) + " counted", local + remote == blocks && s.local_elements + s.remote_elements == n);
+		if (!scheduler.options().cross_node) check(std::string(placement) + " local", remote == 0);
+	}
+
+	// first touch through the scheduler zeroes the whole buffer
+	sweep_scheduler scheduler(placement_options::parse("none,threads=3"), topology);
+	node_buffer<Posit32> buffer = scheduler.allocate<Posit32>(n, block_size);
+	bool zero = buffer.size() == n;
+	for (size_t i = 0; i < n; ++i) zero = zero && buffer[i] == Posit32(0);
+	check("allocate", zero);
+	std::vector<size_t> done(7, 0);
+	scheduler.run(done.size(), [&](size_t t) { done[t] = t + 1; });
+	check("run", done == std::vector<size_t>{ 1, 2, 3, 4, 5, 6, 7 });
+
+	std::cout << "sweep_scheduler: " << (failures == 0 ? "PASS" : "FAIL") << std::endl;
+	return (failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+catch (const char* msg) {
+	std::cerr << msg << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const sw::universal::universal_arithmetic_exception& err) {
+	std::cerr << "Unprocessed universal arithmetic exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const sw::universal::universal_internal_exception& err) {
+	std::cerr << "Unprocessed universal internal exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (...) {
+	std::cerr << "Caught unknown exception" << std::endl;
+	return EXIT_FAILURE;
+}
@@ -0,0 +1,87 @@
+// two_norm.cpp: parallel_two_norm against a long double reference, and sqrt_batch against fast_sqrt
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include <mathfunction/sqrt_kernels.hpp>
+#include <mathfunction/sqrt_batch.hpp>
+#include <mathfunction/input_generator.hpp>
+#include <mathfunction/encoding.hpp>
+#include <mathfunction/ulp.hpp>
+
+// log-uniform elements on [lo, hi]; long enough for the norm to run on several threads
+template <typename T>
+int verify(double lo, double hi, double max_ulp) {
+	int failures = 0;
+	const std::string type_name = number_type_name<T>::value;
+	input_options options;
+	options.lo = lo;
+	options.hi = hi;
+	options.samples = 2 * parallel_min_elements + 17;
+	std::vector<T> v = make_input_generator<T>("log_uniform", options)->generate();
+	for (size_t i = 1; i < v.size(); i += 2) v[i] = -v[i];
+
+	// the root of the sum of squares, in units of the last place of the norm
+	long double sum = 0.0L;
+	for (const T& x : v) sum += static_cast<long double>(x) * static_cast<long double>(x);
+	const long double reference = std::sqrt(sum);
+	const T norm = parallel_two_norm(v.data(), v.size());
+	const double error = static_cast<double>(std::fabs(static_cast<long double>(norm) - reference) / ulp_at(norm));
+	if (!(error <= max_ulp)) {
+		std::cerr << std::setw(10) << type_name << ": two norm " << norm << " is " << error << " ulp from " << static_cast<double>(reference)
+		          << ", expected at most " << max_ulp << std::endl;
+		++failures;
+	}
+	if (parallel_two_norm(v.data(), 0) != T(0) || parallel_two_norm(v.data(), 1) != (v[0] < T(0) ? -v[0] : v[0])) ++failures;
+
+	std::vector<T> roots(v.size());
+	for (auto& x : v) x = (x < T(0)) ? -x : x;
+	sqrt_batch(v.data(), roots.data(), v.size());
+	for (size_t i = 0; i < v.size(); ++i) {
+		T expected;
+		if constexpr (std::is_floating_point_v<T>) expected = std::sqrt(v[i]);
+		else expected = fast_sqrt(v[i]);
+		if (encode(roots[i]) != encode(expected)) {
+			if (failures < 5) std::cerr << std::setw(10) << type_name << ": sqrt_batch(" << v[i] << ") = " << roots[i] << ", expected " << expected << std::endl;
+			++failures;
+		}
+	}
+	return failures;
+}
+
+int main(int argc, char** argv)
+try {
+	int failures = 0;
+
+	// a posit norm rounds the exact sum of squares and then its root, which
+	// stays within 0.75 ulp while the sum keeps as many fraction bits as the
+	// root: the posits taper, so the ranges keep the sum of all the squares
+	// near 1, in the regime of full precision [1/16, 16); the others round the
+	// root of a wide sum once
+	failures += verify<Posit16>(1e-4, 1e-2, 0.75);
+	failures += verify<Posit32>(1e-4, 1e-2, 0.75);
+	failures += verify<Fixpnt16>(0.0625, 0.5, 0.5);
+	failures += verify<Float>(1e-15, 1e15, 0.5);
+	failures += verify<Double>(1e-100, 1e100, 0.5);
+
+	std::cout << "two_norm: " << (failures == 0 ? "PASS" : "FAIL") << std::endl;
+	return (failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+catch (const char* msg) {
+	std::cerr << msg << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const sw::universal::universal_arithmetic_exception& err) {
+	std::cerr << "Unprocessed universal arithmetic exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (const sw::universal::universal_internal_exception& err) {
+	std::cerr << "Unprocessed universal internal exception: " << err.what() << std::endl;
+	return EXIT_FAILURE;
+}
+catch (...) {
+	std::cerr << "Caught unknown exception" << std::endl;
+	return EXIT_FAILURE;
+}